@@ -0,0 +1,145 @@
+/*
+* @file Annulus_Benchmark.cpp
+* @brief Measures the annulus kernel on each instruction set the processor supports: the time per
+* point and the throughput on random points, for a thin annulus that keeps few points and a wide one
+* that keeps many, and checks that every instruction set finds the same points as the scalar kernel.
+* Then times Annulus_Query on a large grid against the scalar loop it replaced, which took the
+* square root of two pow calls for every nearby grid point.
+*
+* Usage: Annulus_Benchmark [point_count] [grid_size]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include "../Toggle Points Method/Annulus_Query.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+* The best fit point search of Annulus_Query before the annulus kernel
+*/
+static std::vector<Annulus_Point> get_best_fit_points_scalar(const Grid_Model& grid, unsigned int center_x, unsigned int center_y,
+	double radius, int threshold) {
+	int grid_spacing = (int)grid.get_grid_spacing();
+	int grid_end = grid_spacing * grid.get_grid_size();
+	int start_indx_x = std::max((int)center_x - (int)radius - ((int)center_x - (int)radius) % grid_spacing, grid_spacing);
+	int start_indx_y = std::max((int)center_y - (int)radius - ((int)center_y - (int)radius) % grid_spacing, grid_spacing);
+	int end_indx_x = start_indx_x + ((int)radius << 1);
+	int end_indx_y = start_indx_y + ((int)radius << 1);
+	end_indx_x = std::min(end_indx_x + (grid_spacing - end_indx_x % grid_spacing), grid_end);
+	end_indx_y = std::min(end_indx_y + (grid_spacing - end_indx_y % grid_spacing), grid_end);
+
+	std::vector<Annulus_Point> best_fit_points;
+	for (int i = start_indx_x / grid_spacing; i <= end_indx_x / grid_spacing; ++i) {
+		for (int j = start_indx_y / grid_spacing; j <= end_indx_y / grid_spacing; ++j) {
+			const cv::Point& point = grid.get_grid_point(i - 1, j - 1).point;
+			double dist_bwn_pt_to_cntr = std::sqrt(std::pow(point.x - (double)center_x, 2) + std::pow(point.y - (double)center_y, 2));
+			if (dist_bwn_pt_to_cntr >= std::abs(radius - threshold) && dist_bwn_pt_to_cntr <= std::abs(radius + threshold))
+			{
+				best_fit_points.push_back({ i - 1, j - 1, dist_bwn_pt_to_cntr });
+			}
+		}
+	}
+	return best_fit_points;
+}
+
+int main(int argc, char** argv) {
+	size_t point_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	int grid_size = (argc > 2) ? std::atoi(argv[2]) : 1000;
+	const int repetitions = 50;
+	const Annulus_Isa isas[] = { annulus_scalar, annulus_sse2, annulus_avx2, annulus_avx512 };
+
+	std::mt19937 generator(40);
+	std::uniform_real_distribution<double> coordinate(0.0, 1000.0);
+	std::vector<double> xs(point_count), ys(point_count);
+	for (size_t p = 0; p < point_count; ++p) {
+		xs[p] = coordinate(generator);
+		ys[p] = coordinate(generator);
+	}
+	std::vector<uint32_t> indices(point_count), scalar_indices(point_count);
+	std::vector<double> squared_distances(point_count), scalar_squared_distances(point_count);
+
+	std::cout << "Annulus kernel on " << point_count << " random points, best instruction set "
+		<< get_annulus_isa_name(get_best_annulus_isa()) << std::endl;
+	std::cout << std::setw(8) << "isa" << std::setw(10) << "width" << std::setw(10) << "kept %" << std::setw(10) << "ns/pt"
+		<< std::setw(12) << "Gpts/s" << std::setw(10) << "speedup" << std::endl;
+	std::cout << std::fixed;
+	for (double width : { 2.0, 100.0 }) {
+		double lower_squared, upper_squared;
+		get_annulus_squared_bounds(300.0 - width / 2, 300.0 + width / 2, lower_squared, upper_squared);
+		size_t scalar_found = find_annulus_points(xs.data(), ys.data(), point_count, 500.0, 500.0, lower_squared, upper_squared,
+			scalar_indices.data(), scalar_squared_distances.data(), annulus_scalar);
+		double scalar_ns = 0.0;
+		for (Annulus_Isa isa : isas) {
+			if (!is_annulus_isa_supported(isa))
+			{
+				std::cout << std::setw(8) << get_annulus_isa_name(isa) << "  not supported" << std::endl;
+				continue;
+			}
+			size_t found = 0;
+			Clock::time_point start = Clock::now();
+			for (int r = 0; r < repetitions; ++r) {
+				found = find_annulus_points(xs.data(), ys.data(), point_count, 500.0, 500.0, lower_squared, upper_squared,
+					indices.data(), squared_distances.data(), isa);
+			}
+			double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / repetitions / point_count;
+			if (isa == annulus_scalar)
+				scalar_ns = ns;
+			bool same = found == scalar_found;
+			for (size_t k = 0; same && k < found; ++k) {
+				same = indices[k] == scalar_indices[k] && squared_distances[k] == scalar_squared_distances[k];
+			}
+			std::cout << std::setw(8) << get_annulus_isa_name(isa) << std::setprecision(0) << std::setw(10) << width
+				<< std::setprecision(2) << std::setw(10) << 100.0 * found / point_count << std::setprecision(3) << std::setw(10) << ns
+				<< std::setw(12) << 1.0 / ns << std::setprecision(2) << std::setw(10) << scalar_ns / ns
+				<< (same ? "" : "  differs from scalar") << std::endl;
+		}
+	}
+
+	// Radius Drag queries on a large grid, the whole grid inside the bounding box of the circle
+	const unsigned int grid_spacing = 10;
+	Grid_Model grid(grid_spacing, grid_size);
+	Annulus_Query annulus_query(grid);
+	const int query_count = 200;
+	std::uniform_int_distribution<int> center(0, grid_spacing * grid_size);
+	std::uniform_real_distribution<double> radius(10.0, grid_spacing * grid_size);
+	std::vector<unsigned int> center_xs(query_count), center_ys(query_count);
+	std::vector<double> radii(query_count);
+	for (int q = 0; q < query_count; ++q) {
+		center_xs[q] = center(generator);
+		center_ys[q] = center(generator);
+		radii[q] = radius(generator);
+	}
+	const int threshold = 10;
+
+	std::cout << std::endl << "Annulus_Query on a " << grid_size << " x " << grid_size << " grid, " << query_count << " queries" << std::endl;
+	std::cout << std::setw(8) << "isa" << std::setw(14) << "us/query" << std::setw(10) << "speedup" << std::endl;
+	size_t scalar_point_count = 0;
+	Clock::time_point start = Clock::now();
+	for (int q = 0; q < query_count; ++q) {
+		scalar_point_count += get_best_fit_points_scalar(grid, center_xs[q], center_ys[q], radii[q], threshold).size();
+	}
+	double scalar_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / query_count;
+	std::cout << std::setw(8) << "pow" << std::setprecision(1) << std::setw(14) << scalar_us << std::setprecision(2) << std::setw(10) << 1.0 << std::endl;
+	for (Annulus_Isa isa : isas) {
+		if (!is_annulus_isa_supported(isa))
+			continue;
+		annulus_query.set_isa(isa);
+		size_t found_point_count = 0;
+		start = Clock::now();
+		for (int q = 0; q < query_count; ++q) {
+			found_point_count += annulus_query.get_best_fit_points(center_xs[q], center_ys[q], radii[q], threshold).size();
+		}
+		double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / query_count;
+		std::cout << std::setw(8) << get_annulus_isa_name(isa) << std::setprecision(1) << std::setw(14) << us
+			<< std::setprecision(2) << std::setw(10) << scalar_us / us
+			<< (found_point_count == scalar_point_count ? "" : "  differs from pow") << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,130 @@
+/*
+* @file Anytime_Benchmark.cpp
+* @brief Fits noisy circles of 1K to 10M points with Best_Fitting_Circle::compute_anytime_fit under
+* time budgets from 100 us to unlimited, and with a target RMS residual just above the converged one.
+* Reports the median, 99th percentile and worst latency, how often the fit converged and how much
+* larger its RMS residual is than the converged fit's. A fit cannot return sooner than it takes to
+* sweep the points twice, once for the algebraic center and once for its radius.
+*
+* It first checks the failure path: fits whose points stop being readable part way, like a read
+* error, have to stop with stopped_failed and report no circle. The benchmark returns 1 otherwise.
+*
+* Usage: Anytime_Benchmark [max_point_count]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Best_Fitting_Circle.h"
+#include "../Toggle Points Method/Anytime_Fit.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+* Point source whose sweeps fail once a number of them have been made, like a read error part way
+* through a fit
+*/
+class Failing_Points
+{
+private:
+	Point_View<2, cv::Point> view;
+	mutable int sweeps_left;
+public:
+	Failing_Points(const std::vector<cv::Point>& points, int sweeps_left) : view(points) {
+		this->sweeps_left = sweeps_left;
+	}
+	size_t size() const {
+		return view.size();
+	}
+	void get_point(size_t i, double* p) const {
+		view.get_point(i, p);
+	}
+	template <int S, typename Body>
+	bool sweep(double(&totals)[S], Body body) const {
+		if (sweeps_left-- <= 0)
+			return false;
+		return view.sweep(totals, body);
+	}
+};
+
+int main(int argc, char** argv) {
+	size_t max_point_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+	std::mt19937 failure_generator(37);
+	std::vector<cv::Point> failure_points = generate_circle_points(failure_generator, 5000.0, 4000.0, 3000.0, 20.0, 1000, 2.0);
+	int failed_fits = 0, reported_failures = 0;
+	for (int sweeps = 0; sweeps < 8; ++sweeps) {
+		Hypersphere_Fitter<2, Failing_Points> engine(failure_points, sweeps);
+		Anytime_Result result = run_anytime_fit(engine, Fit_Budget(), Clock::now(), 0.0);
+		if (engine.get_sweep_count() > sweeps)
+		{
+			++failed_fits; // The fit needed more sweeps than the points allowed
+			reported_failures += (!result.fit.is_computable && result.stop == stopped_failed);
+		}
+	}
+	std::cout << "failure path: " << reported_failures << " of " << failed_fits << " fits with unreadable points reported no circle" << std::endl;
+	if (failed_fits == 0 || reported_failures != failed_fits)
+		return 1;
+
+	std::cout << std::setw(10) << "points" << std::setw(12) << "budget us" << std::setw(12) << "target rms"
+		<< std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "max us"
+		<< std::setw(11) << "converged" << std::setw(14) << "rms excess" << std::endl;
+	std::cout << std::fixed;
+
+	std::mt19937 generator(31);
+	for (size_t point_count = 1000; point_count <= max_point_count; point_count *= 10) {
+		// Start from a poor guess of the arc: a third of the circle with heavy noise
+		std::vector<cv::Point> points = generate_circle_points(generator, 5000.0, 4000.0, 3000.0, 20.0, point_count, 2.0);
+		int repeats = (int)std::max<size_t>(5, std::min<size_t>(200, 20000000 / point_count));
+
+		Best_Fitting_Circle reference(points);
+		reference.set_verbose(false);
+		double converged_rms = reference.compute_anytime_fit(Fit_Budget()).rms;
+
+		std::vector<Fit_Budget> budgets;
+		for (long long budget_us : { 100LL, 1000LL, 10000LL, 100000LL, 0LL }) {
+			Fit_Budget budget;
+			budget.time_budget = std::chrono::microseconds(budget_us);
+			budgets.push_back(budget);
+		}
+		Fit_Budget target_budget;
+		target_budget.target_rms = converged_rms * 1.001;
+		budgets.push_back(target_budget);
+
+		for (const Fit_Budget& budget : budgets) {
+			std::vector<double> latencies(repeats);
+			int converged_count = 0;
+			double worst_excess = 0.0;
+			for (int r = 0; r < repeats; ++r) {
+				Best_Fitting_Circle best_fit_circle(points);
+				best_fit_circle.set_verbose(false);
+				Clock::time_point start = Clock::now();
+				Anytime_Result result = best_fit_circle.compute_anytime_fit(budget);
+				latencies[r] = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+				converged_count += result.converged;
+				worst_excess = std::max(worst_excess, result.rms / converged_rms - 1.0);
+			}
+			std::sort(latencies.begin(), latencies.end());
+			double budget_us = std::chrono::duration<double, std::micro>(budget.time_budget).count();
+			std::cout << std::setw(10) << point_count << std::setprecision(0) << std::setw(12);
+			if (budget_us > 0)
+				std::cout << budget_us;
+			else
+				std::cout << "-";
+			std::cout << std::setprecision(3) << std::setw(12);
+			if (budget.target_rms > 0)
+				std::cout << budget.target_rms;
+			else
+				std::cout << "-";
+			std::cout << std::setprecision(1) << std::setw(10) << latencies[repeats / 2]
+				<< std::setw(10) << latencies[std::min(repeats - 1, repeats * 99 / 100)] << std::setw(10) << latencies.back()
+				<< std::setw(10) << 100.0 * converged_count / repeats << "%" << std::scientific << std::setprecision(2)
+				<< std::setw(14) << worst_excess << std::fixed << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+* @file Arc_Segment_Benchmark.cpp
+* @brief Splits noisy contours of arcs and lines joined tangentially, from 10K to 10M points, with
+* Arc_Segmenter. Reports the time, the time per point, the number of O(1) fits per point and of
+* deviation sweeps, the number of segments found against the true pieces and how many of them are
+* out of tolerance, and how many true arcs and lines were recovered: the segment holding the middle
+* of a piece has its kind and, for an arc, a radius within 2% of the true one. The offset of the
+* segment ends from the true joins is also reported.
+*
+* Usage: Arc_Segment_Benchmark [max_point_count] [noise]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Arc_Segmenter.h"
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+	size_t max_point_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	double noise = (argc > 2) ? std::atof(argv[2]) : 0.2;
+	const double tolerance = 0.3, max_deviation = 1.2;
+
+	std::cout << "contours of arcs and lines, noise " << noise << ", tolerance " << tolerance << ", max deviation " << max_deviation << std::endl;
+	std::cout << std::setw(10) << "points" << std::setw(10) << "ms" << std::setw(8) << "ns/pt" << std::setw(10) << "fits/pt"
+		<< std::setw(10) << "sweeps" << std::setw(8) << "pieces" << std::setw(10) << "segments" << std::setw(8) << "out tol" << std::setw(8) << "arcs %"
+		<< std::setw(9) << "lines %" << std::setw(12) << "join offset" << std::endl;
+	std::cout << std::fixed;
+
+	std::mt19937 generator(41);
+	for (size_t point_count = 10000; point_count <= max_point_count; point_count *= 10) {
+		std::vector<Contour_Piece> pieces;
+		std::vector<cv::Point2d> points = generate_arc_line_contour(generator, point_count, noise, pieces);
+
+		Clock::time_point start = Clock::now();
+		Arc_Segmenter arc_segmenter(points);
+		arc_segmenter.set_tolerance(tolerance, max_deviation);
+		std::vector<Arc_Segment> segments = arc_segmenter.compute_segments();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		// Find the segment holding the middle of each true piece, and the segment end nearest each true join
+		size_t arc_count = 0, arcs_found = 0, line_count = 0, lines_found = 0, out_of_tolerance = 0;
+		std::vector<size_t> segment_starts(segments.size());
+		for (size_t s = 0; s < segments.size(); ++s) {
+			segment_starts[s] = segments[s].first;
+			if (!segments[s].within_tolerance)
+				++out_of_tolerance;
+		}
+		double join_offset = 0.0;
+		for (size_t p = 0; p < pieces.size(); ++p) {
+			size_t end = (p + 1 < pieces.size()) ? pieces[p + 1].first : points.size();
+			size_t middle = (pieces[p].first + end) / 2;
+			const Arc_Segment& segment = segments[std::upper_bound(segment_starts.begin(), segment_starts.end(), middle) - segment_starts.begin() - 1];
+			if (pieces[p].radius > 0.0)
+			{
+				++arc_count;
+				if (segment.kind == segment_arc && std::abs(segment.radius - pieces[p].radius) < 0.02 * pieces[p].radius)
+					++arcs_found;
+			}
+			else
+			{
+				++line_count;
+				if (segment.kind == segment_line)
+					++lines_found;
+			}
+			if (p > 0)
+			{
+				auto nearest = std::lower_bound(segment_starts.begin(), segment_starts.end(), pieces[p].first);
+				double offset = (nearest != segment_starts.end()) ? std::abs((double)*nearest - (double)pieces[p].first) : (double)points.size();
+				if (nearest != segment_starts.begin())
+					offset = std::min(offset, std::abs((double)*(nearest - 1) - (double)pieces[p].first));
+				join_offset += offset;
+			}
+		}
+		join_offset /= std::max((size_t)1, pieces.size() - 1);
+
+		std::cout << std::setw(10) << point_count << std::setprecision(1) << std::setw(10) << ms << std::setw(8) << 1.0e6 * ms / point_count
+			<< std::setprecision(3) << std::setw(10) << (double)arc_segmenter.get_fit_count() / point_count
+			<< std::setw(10) << arc_segmenter.get_check_count() << std::setw(8) << pieces.size() << std::setw(10) << segments.size() << std::setw(8) << out_of_tolerance
+			<< std::setprecision(1) << std::setw(8) << 100.0 * arcs_found / std::max((size_t)1, arc_count)
+			<< std::setw(9) << 100.0 * lines_found / std::max((size_t)1, line_count) << std::setw(12) << join_offset << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+* @file Bootstrap_Benchmark.cpp
+* @brief Runs Bootstrap_Fitter with 1, 2, 4, ... worker threads up to the number of cores and
+* reports the time, the speedup over one thread and the confidence intervals. The intervals are
+* also checked for coverage: over repeated noisy draws of the same circle, the fraction of 95%
+* intervals that contain the true value is reported. Fails if a confidence level outside (0, 1), or
+* too few resamples to put one in each tail of the interval, is not rejected.
+*
+* Usage: Bootstrap_Benchmark [point_count] [resamples] [coverage_trials]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Bootstrap_Fitter.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static bool contains(Confidence_Interval interval, double value) {
+	return interval.lower <= value && value <= interval.upper;
+}
+
+int main(int argc, char** argv) {
+	size_t point_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000;
+	unsigned int resamples = (argc > 2) ? std::atoi(argv[2]) : 1000;
+	int coverage_trials = (argc > 3) ? std::atoi(argv[3]) : 50;
+	const double center_x = 500.0, center_y = 400.0, radius = 300.0;
+	unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+
+	std::mt19937 generator(5);
+	std::vector<cv::Point> points = generate_circle_points(generator, center_x, center_y, radius, 3.0, point_count, 3.14159265358979);
+	std::cout << point_count << " points on a half circle, " << resamples << " resamples" << std::endl;
+	std::cout << std::setw(8) << "threads" << std::setw(10) << "ms" << std::setw(10) << "speedup"
+		<< std::setw(24) << "center x" << std::setw(24) << "center y" << std::setw(24) << "radius" << std::endl;
+	std::cout << std::fixed;
+	double single_thread_ms = 0.0;
+	for (unsigned int threads = 1;; threads = std::min(2 * threads, cores)) {
+		Bootstrap_Fitter bootstrap_fitter(points, threads);
+		Clock::time_point start = Clock::now();
+		bootstrap_fitter.compute_bootstrap(resamples);
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		if (threads == 1)
+			single_thread_ms = ms;
+		Confidence_Interval x = bootstrap_fitter.get_center_x_interval();
+		Confidence_Interval y = bootstrap_fitter.get_center_y_interval();
+		Confidence_Interval r = bootstrap_fitter.get_radius_interval();
+		std::cout << std::setw(8) << threads << std::setprecision(1) << std::setw(10) << ms
+			<< std::setprecision(2) << std::setw(10) << single_thread_ms / ms << std::setprecision(3)
+			<< std::setw(12) << x.lower << std::setw(12) << x.upper
+			<< std::setw(12) << y.lower << std::setw(12) << y.upper
+			<< std::setw(12) << r.lower << std::setw(12) << r.upper << std::endl;
+		if (threads == cores)
+			break;
+	}
+
+	// Coverage of the 95% intervals on fresh draws of the same circle
+	int covered_x = 0, covered_y = 0, covered_r = 0;
+	for (int trial = 0; trial < coverage_trials; ++trial) {
+		std::vector<cv::Point> draw = generate_circle_points(generator, center_x, center_y, radius, 3.0, 500, 3.14159265358979);
+		Bootstrap_Fitter bootstrap_fitter(draw);
+		if (!bootstrap_fitter.compute_bootstrap(200, 0.95, trial + 1))
+			continue;
+		covered_x += contains(bootstrap_fitter.get_center_x_interval(), center_x);
+		covered_y += contains(bootstrap_fitter.get_center_y_interval(), center_y);
+		covered_r += contains(bootstrap_fitter.get_radius_interval(), radius);
+	}
+	if (coverage_trials > 0)
+		std::cout << "95% interval coverage over " << coverage_trials << " draws of 500 points: center x "
+			<< std::setprecision(2) << (double)covered_x / coverage_trials << ", center y " << (double)covered_y / coverage_trials
+			<< ", radius " << (double)covered_r / coverage_trials << std::endl;
+
+	// Arguments that leave an interval undefined have to be rejected
+	std::vector<cv::Point> draw = generate_circle_points(generator, center_x, center_y, radius, 3.0, 100);
+	Bootstrap_Fitter bootstrap_fitter(draw, 1);
+	bool is_rejected = !bootstrap_fitter.compute_bootstrap(200, -0.5) && !bootstrap_fitter.compute_bootstrap(200, 0.0)
+		&& !bootstrap_fitter.compute_bootstrap(200, 1.0) && !bootstrap_fitter.compute_bootstrap(200, 1.5)
+		&& !bootstrap_fitter.compute_bootstrap(39, 0.95) && !bootstrap_fitter.compute_bootstrap(0, 0.95);
+	bool is_accepted = bootstrap_fitter.compute_bootstrap(40, 0.95) && bootstrap_fitter.compute_bootstrap(20, 0.9);
+	if (!is_rejected || !is_accepted)
+	{
+		std::cout << "Invalid confidence levels or resample counts were not rejected" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,98 @@
+/*
+* @file C_API_Check.c
+* @brief Calls the C interface of Best_Fit_C_API.h from C, the way a service in another language
+* would, and checks its argument validation and its results: null coordinates, descending set ends,
+* a null result array, an empty batch, and a known circle fitted alone and within a batch of sets
+* that take every fitting path. Returns 1 if any check fails.
+*
+* Usage: C_API_Check
+*
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include "../Toggle Points Method/Best_Fit_C_API.h"
+
+static int failures = 0;
+
+/*
+* Reports a failed check
+*/
+static void check(int condition, const char* description) {
+	if (!condition)
+	{
+		printf("FAILED: %s\n", description);
+		++failures;
+	}
+}
+
+/*
+* Checks a fitted circle against the expected one
+*/
+static int is_circle(const best_fit_circle* circle, double center_x, double center_y, double radius) {
+	return circle->is_computable && fabs(circle->center_x - center_x) < 1.0e-6
+		&& fabs(circle->center_y - center_y) < 1.0e-6 && fabs(circle->radius - radius) < 1.0e-6;
+}
+
+int main(void) {
+	/* Points exactly on the circle of radius 100 around (300, 200) */
+	const int32_t circle_points[] = { 400, 200, 200, 200, 300, 300, 300, 100, 360, 280, 240, 280,
+		360, 120, 240, 120, 380, 260, 220, 260, 380, 140, 220, 140 };
+	const size_t circle_point_count = sizeof(circle_points) / sizeof(circle_points[0]) / 2;
+	best_fit_circle results[4];
+	best_fit_circle result;
+	size_t set_ends[4];
+
+	/* Argument validation */
+	set_ends[0] = 5;
+	check(best_fit_circle_fit_batch(NULL, set_ends, 1, 1, results) == BEST_FIT_INVALID_ARGUMENT,
+		"null coordinates with a non empty set are rejected");
+	set_ends[0] = 6;
+	set_ends[1] = 3;
+	check(best_fit_circle_fit_batch(circle_points, set_ends, 2, 1, results) == BEST_FIT_INVALID_ARGUMENT,
+		"descending set ends are rejected");
+	set_ends[0] = 6;
+	check(best_fit_circle_fit_batch(circle_points, set_ends, 1, 1, NULL) == BEST_FIT_INVALID_ARGUMENT,
+		"a null result array is rejected");
+	check(best_fit_circle_fit_batch(circle_points, NULL, 1, 1, results) == BEST_FIT_INVALID_ARGUMENT,
+		"null set ends are rejected");
+	check(best_fit_circle_fit(circle_points, circle_point_count, NULL) == BEST_FIT_INVALID_ARGUMENT,
+		"a null result is rejected by best_fit_circle_fit");
+
+	/* Empty batches and empty sets */
+	check(best_fit_circle_fit_batch(NULL, NULL, 0, 0, NULL) == BEST_FIT_OK, "an empty batch succeeds");
+	set_ends[0] = 0;
+	results[0].is_computable = 1;
+	check(best_fit_circle_fit_batch(NULL, set_ends, 1, 1, results) == BEST_FIT_OK && !results[0].is_computable,
+		"an empty set with null coordinates is fitted as not computable");
+
+	/* One known circle */
+	check(best_fit_circle_fit(circle_points, circle_point_count, &result) == BEST_FIT_OK
+		&& is_circle(&result, 300.0, 200.0, 100.0), "best_fit_circle_fit finds the known circle");
+
+	/* A batch over every path: the general fit, too few points, aligned points and a small set */
+	{
+		const int32_t batch_points[] = { 400, 200, 200, 200, 300, 300, 300, 100, 360, 280, 240, 280,
+			360, 120, 240, 120, 380, 260, 220, 260, 380, 140, 220, 140,
+			0, 0, 10, 10,
+			0, 0, 10, 10, 20, 20,
+			400, 200, 300, 300, 200, 200, 300, 100 };
+		set_ends[0] = 12;
+		set_ends[1] = 14;
+		set_ends[2] = 17;
+		set_ends[3] = 21;
+		check(best_fit_circle_fit_batch(batch_points, set_ends, 4, 2, results) == BEST_FIT_OK, "the batch is fitted");
+		check(is_circle(&results[0], 300.0, 200.0, 100.0), "the 12 point set of the batch is the known circle");
+		check(!results[1].is_computable, "two points are not computable");
+		check(!results[2].is_computable, "aligned points are not computable");
+		check(is_circle(&results[3], 300.0, 200.0, 100.0), "the 4 point set of the batch is the known circle");
+	}
+
+	if (failures > 0)
+	{
+		printf("%d checks failed\n", failures);
+		return 1;
+	}
+	printf("All C interface checks passed\n");
+	return 0;
+}
@@ -0,0 +1,80 @@
+/*
+* @file Concentric_Benchmark.cpp
+* @brief Fits sets of 2 to 500 concentric rings, each sampled on a random partial arc, jointly with
+* Concentric_Fitter and separately ring by ring with Hierarchical_Fitter. Reports the time of both,
+* the sweeps and time per point per sweep of the joint fit, the error of the shared center and how
+* far apart the separately fitted centers are.
+*
+* Usage: Concentric_Benchmark [max_point_count] [threads]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Concentric_Fitter.h"
+#include "../Toggle Points Method/Hierarchical_Fitter.h"
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+	size_t max_point_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	unsigned int threads = (argc > 2) ? std::atoi(argv[2]) : 0;
+	const double center_x = 5000.0, center_y = 4000.0, noise = 1.0;
+
+	std::cout << std::setw(10) << "points" << std::setw(8) << "rings" << std::setw(12) << "joint ms" << std::setw(8) << "sweeps"
+		<< std::setw(14) << "ns/pt/sweep" << std::setw(14) << "center error" << std::setw(14) << "separate ms"
+		<< std::setw(16) << "center spread" << std::setw(16) << "worst radius" << std::endl;
+	std::cout << std::fixed;
+
+	std::mt19937 generator(23);
+	std::uniform_real_distribution<double> start_angle(0.0, 2 * 3.14159265358979);
+	for (size_t point_count = 100000; point_count <= max_point_count; point_count *= 10) {
+		for (size_t ring_count : { 2, 10, 100, 500 }) {
+			std::vector<cv::Point> points;
+			std::vector<int> labels;
+			std::vector<std::vector<cv::Point>> rings(ring_count);
+			std::vector<double> true_radii(ring_count);
+			for (size_t g = 0; g < ring_count; ++g) {
+				true_radii[g] = 200.0 + 3000.0 * g / ring_count;
+				rings[g] = generate_circle_points(generator, center_x, center_y, true_radii[g], noise, point_count / ring_count, 2.0, start_angle(generator));
+				points.insert(points.end(), rings[g].begin(), rings[g].end());
+				labels.insert(labels.end(), rings[g].size(), (int)g);
+			}
+
+			Concentric_Fitter concentric_fitter(points, labels, threads);
+			Clock::time_point start = Clock::now();
+			concentric_fitter.compute_best_fit_circles();
+			double joint_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			Circle_Center center = concentric_fitter.get_center_coordinate();
+			double worst_radius = 0.0;
+			for (size_t g = 0; g < ring_count; ++g) {
+				worst_radius = std::max(worst_radius, std::abs(concentric_fitter.get_radii()[g] - true_radii[g]));
+			}
+
+			// Separate fits: one center per ring
+			double min_x = 1.0e18, max_x = -1.0e18, min_y = 1.0e18, max_y = -1.0e18;
+			start = Clock::now();
+			for (size_t g = 0; g < ring_count; ++g) {
+				Hierarchical_Fitter ring_fitter(rings[g]);
+				ring_fitter.compute_best_fit_circle();
+				Circle_Center ring_center = ring_fitter.get_center_coordinate();
+				min_x = std::min(min_x, ring_center.x);
+				max_x = std::max(max_x, ring_center.x);
+				min_y = std::min(min_y, ring_center.y);
+				max_y = std::max(max_y, ring_center.y);
+			}
+			double separate_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+			std::cout << std::setw(10) << points.size() << std::setw(8) << ring_count << std::setprecision(1) << std::setw(12) << joint_ms
+				<< std::setw(8) << concentric_fitter.get_pass_count() << std::setprecision(2)
+				<< std::setw(14) << 1.0e6 * joint_ms / (concentric_fitter.get_pass_count() * (double)points.size()) << std::setprecision(4)
+				<< std::setw(14) << std::hypot(center.x - center_x, center.y - center_y) << std::setprecision(1)
+				<< std::setw(14) << separate_ms << std::setprecision(3) << std::setw(16) << std::hypot(max_x - min_x, max_y - min_y)
+				<< std::setprecision(4) << std::setw(16) << worst_radius << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,65 @@
+/*
+* @file Extremal_Benchmark.cpp
+* @brief Computes the minimum enclosing and maximum inscribed circles of noisy rings of 1K to 10M
+* points and reports the time, the time per point, the number of inscribed circle moves and the
+* radii against the true circle. Every result is checked: no point may lie outside the enclosing
+* circle or inside the inscribed one.
+*
+* Usage: Extremal_Benchmark [max_point_count]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Extremal_Circle_Fitter.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+* Returns the smallest and largest distance from a center to the points
+*/
+static void get_distance_range(const std::vector<cv::Point>& points, Circle_Center center, double& nearest, double& farthest) {
+	nearest = std::numeric_limits<double>::infinity();
+	farthest = 0.0;
+	for (auto point : points) {
+		double distance = std::hypot(point.x - center.x, point.y - center.y);
+		nearest = std::min(nearest, distance);
+		farthest = std::max(farthest, distance);
+	}
+}
+
+int main(int argc, char** argv) {
+	size_t max_point_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	const double center_x = 5000.0, center_y = 4000.0, radius = 3000.0, noise = 5.0;
+
+	std::cout << "ring of radius " << radius << " with radial noise " << noise << std::endl;
+	std::cout << std::setw(10) << "points" << std::setw(10) << "mode" << std::setw(10) << "ms" << std::setw(10) << "ns/pt"
+		<< std::setw(8) << "moves" << std::setw(12) << "radius" << std::setw(10) << "valid" << std::endl;
+	std::cout << std::fixed;
+
+	std::mt19937 generator(17);
+	for (size_t point_count = 1000; point_count <= max_point_count; point_count *= 10) {
+		std::vector<cv::Point> points = generate_circle_points(generator, center_x, center_y, radius, noise, point_count);
+		for (Fit_Mode mode : { minimum_enclosing_fit, maximum_inscribed_fit }) {
+			Extremal_Circle_Fitter extremal_circle_fitter(points);
+			Clock::time_point start = Clock::now();
+			bool is_computable = (mode == minimum_enclosing_fit) ? extremal_circle_fitter.compute_minimum_enclosing_circle()
+				: extremal_circle_fitter.compute_maximum_inscribed_circle();
+			double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+			double nearest, farthest;
+			get_distance_range(points, extremal_circle_fitter.get_center_coordinate(), nearest, farthest);
+			double fitted_radius = extremal_circle_fitter.get_radius();
+			bool valid = is_computable && ((mode == minimum_enclosing_fit) ? farthest <= fitted_radius * (1 + 1.0e-9)
+				: nearest >= fitted_radius * (1 - 1.0e-9));
+			std::cout << std::setw(10) << point_count << std::setw(10) << ((mode == minimum_enclosing_fit) ? "enclosing" : "inscribed")
+				<< std::setprecision(1) << std::setw(10) << ms << std::setprecision(2) << std::setw(10) << 1.0e6 * ms / point_count
+				<< std::setw(8) << ((mode == minimum_enclosing_fit) ? 0 : extremal_circle_fitter.get_move_count())
+				<< std::setprecision(3) << std::setw(12) << fitted_radius << std::setw(10) << (valid ? "yes" : "NO") << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,76 @@
+/*
+* @file Hierarchical_Benchmark.cpp
+* @brief Compares a coarse to fine Hierarchical_Fitter fit with the plain fit of the full point set,
+* on large synthetic point sets. The plain fit is Hypersphere_Fitter over the points in place: the
+* single sweep algebraic estimate, then every refinement iteration on the full set until the cost
+* stops decreasing. Every point count is run on a full circle, where the algebraic estimate is
+* already close and both fits take about the same time, and on a 60 degree arc, where the full fit
+* needs several iterations on every point.
+*
+* Usage: Hierarchical_Benchmark [tolerance] [point counts ...]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Hierarchical_Fitter.h"
+#include "../Toggle Points Method/Hypersphere_Fitter.h"
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+	double tolerance = (argc > 1) ? std::atof(argv[1]) : 1.0e-3;
+	std::vector<size_t> point_counts;
+	for (int i = 2; i < argc; ++i) {
+		point_counts.push_back(std::strtoull(argv[i], nullptr, 10));
+	}
+	if (point_counts.empty())
+		point_counts = { 1000000, 10000000, 100000000 };
+
+	std::cout << "tolerance = " << tolerance << std::endl;
+	std::cout << std::setw(12) << "points" << std::setw(6) << "arc" << std::setw(12) << "full s" << std::setw(12) << "coarse s"
+		<< std::setw(10) << "speedup" << std::setw(8) << "levels" << std::setw(14) << "center diff"
+		<< std::setw(14) << "radius diff" << std::setw(8) << "match" << std::endl;
+
+	std::mt19937 generator(11);
+	for (size_t point_count : point_counts) {
+	for (double arc_degrees : { 360.0, 60.0 }) {
+		std::vector<cv::Point> points = generate_circle_points(generator, 5000.0, 4000.0, 3000.0, 20.0, point_count,
+			arc_degrees * 3.14159265358979 / 180.0);
+
+		Hypersphere_Fitter<2, Point_View<2, cv::Point>> full_fitter(points);
+		Clock::time_point start = Clock::now();
+		bool full_ok = full_fitter.compute_best_fit_sphere();
+		double full_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		Hierarchical_Fitter coarse_fitter(points, tolerance);
+		start = Clock::now();
+		bool coarse_ok = coarse_fitter.compute_best_fit_circle();
+		double coarse_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		Hypersphere_Fitter<2, Point_View<2, cv::Point>>::Vector full_center = full_fitter.get_center();
+		Circle_Center coarse_center = coarse_fitter.get_center_coordinate();
+		double center_diff = std::hypot(full_center[0] - coarse_center.x, full_center[1] - coarse_center.y);
+		double radius_diff = std::abs(full_fitter.get_radius() - coarse_fitter.get_radius());
+		bool match = full_ok && coarse_ok && center_diff <= tolerance && radius_diff <= tolerance;
+
+		std::cout << std::setw(12) << point_count << std::setw(6) << (int)arc_degrees << std::fixed << std::setprecision(3)
+			<< std::setw(12) << full_seconds << std::setw(12) << coarse_seconds
+			<< std::setw(10) << full_seconds / coarse_seconds << std::setw(8) << coarse_fitter.get_levels().size()
+			<< std::scientific << std::setprecision(2) << std::setw(14) << center_diff << std::setw(14) << radius_diff
+			<< std::setw(8) << (match ? "yes" : "NO") << std::defaultfloat << std::endl;
+
+		// Where the iterations of each fit were spent
+		std::cout << std::setw(12) << "full:" << "  " << point_count << " pts x " << full_fitter.get_iteration_count() << " it" << std::endl;
+		std::cout << std::setw(12) << "coarse:";
+		for (auto& level : coarse_fitter.get_levels()) {
+			std::cout << "  " << level.point_count << " pts x " << level.iterations << " it";
+		}
+		std::cout << std::endl;
+	}
+	}
+	return 0;
+}
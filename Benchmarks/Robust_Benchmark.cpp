@@ -0,0 +1,67 @@
+/*
+* @file Robust_Benchmark.cpp
+* @brief Fits circles with an increasing fraction of outliers with the unweighted least squares
+* path and with Robust_Fitter's Huber and Tukey estimators, and reports the center error and the
+* time of each. Outliers are spread uniformly over a square around the circle.
+*
+* Usage: Robust_Benchmark [point_count] [threads]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Hierarchical_Fitter.h"
+#include "../Toggle Points Method/Robust_Fitter.h"
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+	size_t point_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	unsigned int threads = (argc > 2) ? std::atoi(argv[2]) : 0;
+	const double center_x = 5000.0, center_y = 4000.0, radius = 3000.0;
+
+	std::cout << point_count << " points" << std::endl;
+	std::cout << std::setw(10) << "outliers" << std::setw(12) << "method" << std::setw(14) << "center error"
+		<< std::setw(14) << "radius error" << std::setw(10) << "ms" << std::setw(8) << "passes"
+		<< std::setw(14) << "ns/pt/pass" << std::endl;
+	std::cout << std::fixed;
+
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<double> box(-2 * radius, 2 * radius);
+	for (int percent = 0; percent <= 40; percent += 10) {
+		size_t outlier_count = point_count * percent / 100;
+		std::vector<cv::Point> points = generate_circle_points(generator, center_x, center_y, radius, 5.0, point_count - outlier_count);
+		for (size_t i = 0; i < outlier_count; ++i) {
+			points.push_back(cv::Point((int)(center_x + box(generator)), (int)(center_y + box(generator))));
+		}
+
+		// Unweighted path: every iteration of the plain fitter on the full set
+		Hierarchical_Fitter unweighted(points, 0.0, 64, points.size());
+		Clock::time_point start = Clock::now();
+		unweighted.compute_best_fit_circle();
+		double unweighted_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		Circle_Center center = unweighted.get_center_coordinate();
+		std::cout << std::setw(9) << percent << "%" << std::setw(12) << "unweighted" << std::setprecision(3)
+			<< std::setw(14) << std::hypot(center.x - center_x, center.y - center_y)
+			<< std::setw(14) << std::abs(unweighted.get_radius() - radius) << std::setprecision(1)
+			<< std::setw(10) << unweighted_ms << std::endl;
+
+		for (M_Estimator estimator : { least_squares, huber, tukey }) {
+			Robust_Fitter robust_fitter(points, estimator, threads);
+			start = Clock::now();
+			robust_fitter.compute_best_fit_circle();
+			double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			center = robust_fitter.get_center_coordinate();
+			const char* name = (estimator == least_squares) ? "weighted LS" : (estimator == huber) ? "huber" : "tukey";
+			std::cout << std::setw(10) << "" << std::setw(12) << name << std::setprecision(3)
+				<< std::setw(14) << std::hypot(center.x - center_x, center.y - center_y)
+				<< std::setw(14) << std::abs(robust_fitter.get_radius() - radius) << std::setprecision(1)
+				<< std::setw(10) << ms << std::setw(8) << robust_fitter.get_pass_count() << std::setprecision(2)
+				<< std::setw(14) << 1.0e6 * ms / (robust_fitter.get_pass_count() * (double)points.size()) << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*
+* @file Small_Fit_Benchmark.cpp
+* @brief Fits many sets of 3 to 8 noisy points with the general Best_Fitting_Circle path (point
+* triplet initializer and refine_best_fit_circle on a vector) and with Fixed_Size_Fitter, and
+* reports the nanoseconds per fit of each and how often their centers agree. Both paths run the
+* refinement of Hypersphere_Fitter and add up the same sums in the same order, so their centers
+* should always agree. Three points take the closed form circumcenter and are about 10x faster; 4 to
+* 8 points spend most of their time in the same chain of dependent sweeps on both paths, and gain
+* only 1.0 to 1.5x.
+*
+* Usage: Small_Fit_Benchmark [sets_per_size]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Fixed_Size_Fitter.h"
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+	size_t set_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 100000;
+
+	std::cout << set_count << " sets per size" << std::endl;
+	std::cout << std::setw(8) << "points" << std::setw(14) << "general ns" << std::setw(14) << "fixed ns"
+		<< std::setw(10) << "speedup" << std::setw(22) << "centers within 1e-6" << std::endl;
+	std::cout << std::fixed;
+
+	std::mt19937 generator(11);
+	std::uniform_real_distribution<double> position(100.0, 900.0);
+	std::uniform_real_distribution<double> size(20.0, 200.0);
+	for (int n = 3; n <= (int)max_fixed_size_points; ++n) {
+		std::vector<std::vector<cv::Point>> sets(set_count);
+		for (auto& points : sets) {
+			points = generate_circle_points(generator, position(generator), position(generator), size(generator), 2.0, n);
+		}
+
+		// General path: what compute_best_fit_circle ran before small sets were dispatched
+		std::vector<Fit_Result> general(set_count);
+		Clock::time_point start = Clock::now();
+		for (size_t s = 0; s < set_count; ++s) {
+			Best_Fitting_Circle best_fit_circle(sets[s]);
+			best_fit_circle.set_verbose(false);
+			Circle_Center estimate = best_fit_circle.initial_estimate(sets[s]);
+			general[s].is_computable = estimate.x > -1 && estimate.y > -1 && best_fit_circle.refine_best_fit_circle(estimate);
+			general[s].center = best_fit_circle.get_center_coordinate();
+		}
+		double general_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / set_count;
+
+		std::vector<Fit_Result> fixed(set_count);
+		start = Clock::now();
+		for (size_t s = 0; s < set_count; ++s) {
+			double cost;
+			int iteration_count;
+			fit_fixed_size(sets[s].data(), sets[s].size(), fixed[s], cost, iteration_count);
+		}
+		double fixed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / set_count;
+
+		size_t agreeing = 0;
+		for (size_t s = 0; s < set_count; ++s) {
+			if (general[s].is_computable == fixed[s].is_computable && (!fixed[s].is_computable
+				|| std::hypot(general[s].center.x - fixed[s].center.x, general[s].center.y - fixed[s].center.y) < 1.0e-6))
+				++agreeing;
+		}
+		std::cout << std::setw(8) << n << std::setprecision(1) << std::setw(14) << general_ns << std::setw(14) << fixed_ns
+			<< std::setprecision(2) << std::setw(10) << general_ns / fixed_ns
+			<< std::setw(21) << 100.0 * agreeing / set_count << "%" << std::endl;
+	}
+	return 0;
+}
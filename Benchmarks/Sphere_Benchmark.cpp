@@ -0,0 +1,90 @@
+/*
+* @file Sphere_Benchmark.cpp
+* @brief Fits large noisy 3D scans of a sphere with Hypersphere_Fitter<3> and, for comparison, circles
+* of the same point count with the same engine at D = 2. Reports the time, iterations, time per point
+* and the center and radius errors of each, then fits a batch of small sphere sets with
+* Batch_Fitter::fit_spheres.
+*
+* Usage: Sphere_Benchmark [max_point_count] [threads]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Batch_Fitter.h"
+
+typedef std::chrono::steady_clock Clock;
+
+int main(int argc, char** argv) {
+	size_t max_point_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	unsigned int threads = (argc > 2) ? std::atoi(argv[2]) : 0;
+	const double radius = 3000.0, noise = 2.0;
+	const cv::Point3d center(5000.0, 4000.0, -2000.0);
+
+	std::cout << std::setw(4) << "D" << std::setw(12) << "points" << std::setw(10) << "ms" << std::setw(8) << "iter"
+		<< std::setw(10) << "ns/pt" << std::setw(14) << "center error" << std::setw(14) << "radius error" << std::endl;
+	std::cout << std::fixed;
+
+	std::mt19937 generator(29);
+	for (size_t point_count = 10000; point_count <= max_point_count; point_count *= 10) {
+		std::vector<cv::Point3d> sphere_points = generate_sphere_points(generator, center, radius, noise, point_count);
+		Clock::time_point start = Clock::now();
+		Hypersphere_Fitter<3> sphere_fitter(sphere_points);
+		bool sphere_fitted = sphere_fitter.compute_best_fit_sphere();
+		double sphere_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		Hypersphere_Fitter<3>::Vector sphere_center = sphere_fitter.get_center();
+		double sphere_error = std::sqrt(std::pow(sphere_center[0] - center.x, 2) + std::pow(sphere_center[1] - center.y, 2)
+			+ std::pow(sphere_center[2] - center.z, 2));
+
+		std::vector<cv::Point> circle_points = generate_circle_points(generator, center.x, center.y, radius, noise, point_count);
+		start = Clock::now();
+		Hypersphere_Fitter<2> circle_fitter(circle_points);
+		bool circle_fitted = circle_fitter.compute_best_fit_sphere();
+		double circle_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		Hypersphere_Fitter<2>::Vector circle_center = circle_fitter.get_center();
+		double circle_error = std::hypot(circle_center[0] - center.x, circle_center[1] - center.y);
+
+		std::cout << std::setw(4) << 3 << std::setw(12) << point_count << std::setprecision(2) << std::setw(10) << sphere_ms
+			<< std::setw(8) << sphere_fitter.get_iteration_count() << std::setw(10) << 1.0e6 * sphere_ms / point_count
+			<< std::setprecision(4) << std::setw(14) << sphere_error << std::setw(14) << std::abs(sphere_fitter.get_radius() - radius)
+			<< (sphere_fitted ? "" : "  not converged") << std::endl;
+		std::cout << std::setw(4) << 2 << std::setw(12) << point_count << std::setprecision(2) << std::setw(10) << circle_ms
+			<< std::setw(8) << circle_fitter.get_iteration_count() << std::setw(10) << 1.0e6 * circle_ms / point_count
+			<< std::setprecision(4) << std::setw(14) << circle_error << std::setw(14) << std::abs(circle_fitter.get_radius() - radius)
+			<< (circle_fitted ? "" : "  not converged") << std::endl;
+	}
+
+	// Batch of small scans, such as spherical features measured by a probe
+	const size_t set_count = 100000;
+	std::uniform_real_distribution<double> position(-1000.0, 1000.0);
+	std::uniform_real_distribution<double> size(5.0, 50.0);
+	std::uniform_int_distribution<int> points_per_set(20, 200);
+	std::vector<std::vector<cv::Point3d>> sets(set_count);
+	std::vector<cv::Point3d> true_centers(set_count);
+	for (size_t s = 0; s < set_count; ++s) {
+		true_centers[s] = cv::Point3d(position(generator), position(generator), position(generator));
+		sets[s] = generate_sphere_points(generator, true_centers[s], size(generator), 0.05, points_per_set(generator));
+	}
+	Batch_Fitter batch_fitter(threads);
+	Clock::time_point start = Clock::now();
+	std::vector<Sphere_Result> results = batch_fitter.fit_spheres(sets);
+	double batch_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	double worst_error = 0.0;
+	size_t failed = 0;
+	for (size_t s = 0; s < set_count; ++s) {
+		if (!results[s].is_computable)
+		{
+			++failed;
+			continue;
+		}
+		worst_error = std::max(worst_error, std::sqrt(std::pow(results[s].center.x - true_centers[s].x, 2)
+			+ std::pow(results[s].center.y - true_centers[s].y, 2) + std::pow(results[s].center.z - true_centers[s].z, 2)));
+	}
+	std::cout << std::endl << set_count << " sphere sets of 20 to 200 points on " << batch_fitter.get_thread_count() << " threads: "
+		<< std::setprecision(1) << batch_ms << " ms, " << std::setprecision(2) << 1000.0 * batch_ms / set_count << " us/set, worst center error "
+		<< std::setprecision(4) << worst_error << ", failed " << failed << std::endl;
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+* @file Streaming_Benchmark.cpp
+* @brief Writes a large synthetic point file and fits it with Streaming_Fitter, reporting the
+* number of passes, the I/O and compute time and how much of the I/O was hidden behind compute.
+* The file has just been written, so it is usually read back from the page cache and the share of
+* hidden I/O is an upper bound: reads from a cold disk are slower than compute and mostly stall.
+* Files of up to 10M points are also fitted in memory with Hierarchical_Fitter for comparison.
+* Fails if a file ending in a partial point is fitted instead of reported as a read error.
+*
+* Usage: Streaming_Benchmark [point_count] [chunk_points] [file_path]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Streaming_Fitter.h"
+#include "../Toggle Points Method/Hierarchical_Fitter.h"
+
+int main(int argc, char** argv) {
+	size_t point_count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+	size_t chunk_points = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1 << 20;
+	std::string path = (argc > 3) ? argv[3] : "/tmp/streaming_points.bin";
+	const double center_x = 5000.0, center_y = 4000.0, radius = 3000.0;
+
+	// Write the file a chunk at a time so the benchmark itself stays within bounded memory
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	if (file == nullptr)
+	{
+		std::cout << "Could not create " << path << std::endl;
+		return -1;
+	}
+	std::mt19937 generator(5);
+	for (size_t written = 0; written < point_count; written += chunk_points) {
+		std::vector<cv::Point> chunk = generate_circle_points(generator, center_x, center_y, radius, 20.0, std::min(chunk_points, point_count - written));
+		std::fwrite(chunk.data(), sizeof(cv::Point), chunk.size(), file);
+	}
+	std::fclose(file);
+
+	Streaming_Fitter streaming_fitter(path, chunk_points);
+	bool is_computable = streaming_fitter.compute_best_fit_circle();
+	Streaming_Stats stats = streaming_fitter.get_stats();
+	Circle_Center center = streaming_fitter.get_center_coordinate();
+
+	std::cout << std::fixed << std::setprecision(4);
+	std::cout << "points = " << stats.points << ", chunk = " << chunk_points << " points ("
+		<< 2 * chunk_points * sizeof(cv::Point) / (1 << 20) << " MiB buffered)" << std::endl;
+	std::cout << "fit " << (is_computable ? "converged" : "did not converge") << ": center = " << center.x << " , " << center.y
+		<< ", radius = " << streaming_fitter.get_radius() << " (true " << center_x << " , " << center_y << ", " << radius << ")" << std::endl;
+	std::cout << std::setprecision(3);
+	std::cout << "passes = " << stats.passes << ", read = " << stats.bytes_read / (1 << 20) << " MiB, wall = " << stats.wall_seconds
+		<< " s, " << stats.bytes_read / (1 << 20) / stats.wall_seconds << " MiB/s" << std::endl;
+	std::cout << "io = " << stats.io_seconds << " s, compute = " << stats.compute_seconds << " s, stalled = " << stats.stall_seconds
+		<< " s, I/O hidden behind compute = " << (stats.io_seconds > 0 ? 100.0 * (1.0 - stats.stall_seconds / stats.io_seconds) : 100.0)
+		<< " %" << std::endl;
+
+	if (point_count <= 10000000)
+	{
+		// Load the same file and fit it in memory
+		std::vector<cv::Point> points(point_count);
+		file = std::fopen(path.c_str(), "rb");
+		size_t read = std::fread(points.data(), sizeof(cv::Point), point_count, file);
+		std::fclose(file);
+		points.resize(read);
+		Hierarchical_Fitter in_memory_fitter(points, 0.0, 64, points.size());
+		in_memory_fitter.compute_best_fit_circle();
+		Circle_Center in_memory_center = in_memory_fitter.get_center_coordinate();
+		std::cout << std::scientific << std::setprecision(2) << "difference from in memory fit: center = "
+			<< std::hypot(center.x - in_memory_center.x, center.y - in_memory_center.y)
+			<< ", radius = " << std::abs(streaming_fitter.get_radius() - in_memory_fitter.get_radius()) << std::endl;
+	}
+
+	// Cut the file inside its last point: the fit has to fail rather than drop the partial point
+	std::vector<cv::Point> truncated = generate_circle_points(generator, center_x, center_y, radius, 20.0, 1000);
+	file = std::fopen(path.c_str(), "wb");
+	std::fwrite(truncated.data(), 1, truncated.size() * sizeof(cv::Point) - 3, file);
+	std::fclose(file);
+	Streaming_Fitter truncated_fitter(path, 256);
+	bool is_truncation_reported = !truncated_fitter.compute_best_fit_circle();
+	std::remove(path.c_str());
+	if (!is_truncation_reported)
+	{
+		std::cout << "A file ending in a partial point was fitted instead of failing" << std::endl;
+		return 1;
+	}
+	return 0;
+}
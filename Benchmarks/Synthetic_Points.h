@@ -0,0 +1,140 @@
+/*
+* @file Synthetic_Points.h
+* @brief Generators of synthetic point sets shared by the benchmarks. Points are scattered around a
+* known circle or sphere with Gaussian radial noise so the fit can be compared to the true one, or
+* along a known contour of arcs and lines.
+*
+*/
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#pragma once
+#ifndef SYNTHETIC_POINTS
+#define SYNTHETIC_POINTS
+
+/**
+* Generates integer points around a circle
+*
+* @param generator Random number generator
+* @param center_x x coordinate of the true center
+* @param center_y y coordinate of the true center
+* @param radius True radius
+* @param noise Standard deviation of the radial noise
+* @param point_count Number of points
+* @param arc Angular extent of the sampled arc in radians, 2 pi for a full circle
+* @param start_angle Angle where the arc starts
+* @return points Generated points
+*/
+inline std::vector<cv::Point> generate_circle_points(std::mt19937& generator, double center_x, double center_y, double radius,
+	double noise, size_t point_count, double arc = 2 * 3.14159265358979, double start_angle = 0.0) {
+	std::uniform_real_distribution<double> angle(start_angle, start_angle + arc);
+	std::normal_distribution<double> radial_noise(0.0, noise);
+	std::vector<cv::Point> points(point_count);
+	for (size_t i = 0; i < point_count; ++i) {
+		double theta = angle(generator);
+		double r = radius + radial_noise(generator);
+		points[i] = cv::Point((int)std::lround(center_x + r * std::cos(theta)), (int)std::lround(center_y + r * std::sin(theta)));
+	}
+	return points;
+}
+
+/**
+* Generates 3D points around a sphere, uniformly over its surface
+*
+* @param generator Random number generator
+* @param center True center
+* @param radius True radius
+* @param noise Standard deviation of the radial noise
+* @param point_count Number of points
+* @return points Generated points
+*/
+inline std::vector<cv::Point3d> generate_sphere_points(std::mt19937& generator, const cv::Point3d& center, double radius,
+	double noise, size_t point_count) {
+	std::normal_distribution<double> direction(0.0, 1.0);
+	std::normal_distribution<double> radial_noise(0.0, noise);
+	std::vector<cv::Point3d> points(point_count);
+	for (size_t i = 0; i < point_count; ++i) {
+		double ux = direction(generator);
+		double uy = direction(generator);
+		double uz = direction(generator);
+		double scale = (radius + radial_noise(generator)) / std::sqrt(ux * ux + uy * uy + uz * uz);
+		points[i] = cv::Point3d(center.x + ux * scale, center.y + uy * scale, center.z + uz * scale);
+	}
+	return points;
+}
+
+/*
+* Piece of a synthetic contour
+*/
+struct Contour_Piece {
+	size_t first; // Index of the first point
+	double radius; // Radius of an arc, 0 for a line
+};
+
+/**
+* Generates an ordered contour of arcs and straight lines, one after the other and joined
+* tangentially, sampled at a fixed spacing along the contour with Gaussian noise across it
+*
+* @param generator Random number generator
+* @param point_count Number of points
+* @param noise Standard deviation of the noise across the contour
+* @param pieces True arcs and lines of the contour
+* @return points Generated points in contour order
+*/
+inline std::vector<cv::Point2d> generate_arc_line_contour(std::mt19937& generator, size_t point_count, double noise,
+	std::vector<Contour_Piece>& pieces) {
+	const double pi = 3.14159265358979, spacing = 1.0;
+	std::uniform_real_distribution<double> arc_radius(100.0, 2000.0);
+	std::uniform_real_distribution<double> arc_turn(pi / 6, 5 * pi / 6);
+	std::uniform_real_distribution<double> line_length(100.0, 1000.0);
+	std::normal_distribution<double> cross_noise(0.0, noise);
+	std::vector<cv::Point2d> points;
+	points.reserve(point_count);
+	pieces.clear();
+	double x = 0.0, y = 0.0, heading = 0.0;
+	bool is_arc = true;
+	while (points.size() < point_count) {
+		double radius = is_arc ? arc_radius(generator) : 0.0;
+		double turn = (generator() % 2 == 0) ? 1.0 : -1.0; // Left or right
+		double length = is_arc ? radius * arc_turn(generator) : line_length(generator);
+		size_t piece_point_count = std::min((size_t)(length / spacing), point_count - points.size());
+		pieces.push_back({ points.size(), radius });
+		double start_x = x, start_y = y, start_heading = heading;
+		for (size_t k = 0; k < piece_point_count; ++k) {
+			double s = k * spacing;
+			if (is_arc)
+			{
+				heading = start_heading + turn * s / radius;
+				x = start_x + turn * radius * (std::sin(heading) - std::sin(start_heading));
+				y = start_y - turn * radius * (std::cos(heading) - std::cos(start_heading));
+			}
+			else
+			{
+				x = start_x + s * std::cos(heading);
+				y = start_y + s * std::sin(heading);
+			}
+			double offset = cross_noise(generator);
+			points.push_back(cv::Point2d(x - offset * std::sin(heading), y + offset * std::cos(heading)));
+		}
+		// Move to the start of the next piece
+		double s = piece_point_count * spacing;
+		if (is_arc)
+		{
+			heading = start_heading + turn * s / radius;
+			x = start_x + turn * radius * (std::sin(heading) - std::sin(start_heading));
+			y = start_y - turn * radius * (std::cos(heading) - std::cos(start_heading));
+		}
+		else
+		{
+			x = start_x + s * std::cos(heading);
+			y = start_y + s * std::sin(heading);
+		}
+		is_arc = !is_arc;
+	}
+	return points;
+}
+
+#endif
@@ -0,0 +1,151 @@
+/*
+* @file Tracking_Benchmark.cpp
+* @brief Compares fitting every frame of a moving circle from scratch with Circle_Tracker. The
+* circle moves at a constant velocity that changes every 100 frames and jumps 3 to 6 radii every
+* 250 frames, out of the tracking window, so the tracker has to fall back to a full fit. The time
+* and iterations of the steady frames and of the jump frames (the first frame and every jump) are
+* reported separately, since a jump costs the tracker a rejected warm start and a full fit. Fails if
+* the fallback is never taken.
+*
+* Usage: Tracking_Benchmark [frames] [points_per_frame]
+*
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include "Synthetic_Points.h"
+#include "../Toggle Points Method/Circle_Tracker.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct Frame_Truth {
+	double center_x;
+	double center_y;
+	double radius;
+	bool is_jump; // First frame or the circle jumped out of the tracking window
+};
+
+/*
+* Time and iterations of one method, split between steady frames and jump frames
+*/
+struct Method_Costs {
+	double seconds[2] = {};
+	unsigned long long iterations[2] = {};
+	size_t frames[2] = {};
+	unsigned long long full_fits = 0;
+	double center_error = 0.0;
+	size_t failed = 0;
+
+	void add_frame(bool is_jump, double frame_seconds, unsigned long long frame_iterations) {
+		seconds[is_jump] += frame_seconds;
+		iterations[is_jump] += frame_iterations;
+		++frames[is_jump];
+	}
+};
+
+/**
+* Prints one row of the comparison table. The center error is averaged over the fitted frames
+*/
+void print_row(const char* name, const Method_Costs& costs) {
+	size_t frame_count = costs.frames[0] + costs.frames[1];
+	std::cout << std::setw(12) << name;
+	for (int is_jump = 0; is_jump < 2; ++is_jump) {
+		size_t frames = std::max<size_t>(costs.frames[is_jump], 1);
+		std::cout << std::setw(12) << 1.0e6 * costs.seconds[is_jump] / frames << std::setw(12) << (double)costs.iterations[is_jump] / frames;
+	}
+	std::cout << std::setw(12) << costs.full_fits
+		<< std::setw(14) << (costs.failed < frame_count ? costs.center_error / (frame_count - costs.failed) : 0.0)
+		<< std::setw(10) << costs.failed << std::endl;
+}
+
+int main(int argc, char** argv) {
+	size_t frame_count = (argc > 1) ? std::atoi(argv[1]) : 1000;
+	size_t point_count = (argc > 2) ? std::atoi(argv[2]) : 40;
+
+	// Build the sequence up front so every method fits the same points
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> jump_angle(0.0, 2 * CV_PI);
+	std::uniform_real_distribution<double> jump_length(3.0, 6.0);
+	std::uniform_real_distribution<double> speed(-3.0, 3.0);
+	std::vector<Frame_Truth> truth(frame_count);
+	std::vector<std::vector<cv::Point>> frames(frame_count);
+	// The jumps land within jump_area so that the drift between them keeps the circle at positive coordinates
+	const double jump_area_min = 1500.0, jump_area_max = 3500.0;
+	double cx = 2500.0, cy = 2500.0, vx = 1.0, vy = 0.5, r = 120.0;
+	for (size_t f = 0; f < frame_count; ++f) {
+		if (f % 250 == 249)
+		{
+			double next_x, next_y;
+			do {
+				double angle = jump_angle(generator);
+				double length = jump_length(generator) * r;
+				next_x = cx + length * std::cos(angle);
+				next_y = cy + length * std::sin(angle);
+			} while (next_x < jump_area_min || next_x > jump_area_max || next_y < jump_area_min || next_y > jump_area_max);
+			cx = next_x;
+			cy = next_y;
+		}
+		bool is_jump = (f == 0 || f % 250 == 249);
+		if (f % 100 == 99)
+		{
+			vx = speed(generator);
+			vy = speed(generator);
+		}
+		cx += vx;
+		cy += vy;
+		truth[f] = { cx, cy, r, is_jump };
+		frames[f] = generate_circle_points(generator, cx, cy, r, 1.5, point_count);
+	}
+
+	std::cout << frame_count << " frames, " << point_count << " points per frame" << std::endl;
+	std::cout << std::setw(12) << "" << std::setw(24) << "steady frames" << std::setw(24) << "jump frames" << std::endl;
+	std::cout << std::setw(12) << "method" << std::setw(12) << "us/frame" << std::setw(12) << "iter/frame"
+		<< std::setw(12) << "us/frame" << std::setw(12) << "iter/frame"
+		<< std::setw(12) << "full fits" << std::setw(14) << "center error" << std::setw(10) << "failed" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+
+	// Full initialization on every frame
+	Method_Costs full_costs;
+	for (size_t f = 0; f < frame_count; ++f) {
+		Clock::time_point start = Clock::now();
+		Best_Fitting_Circle best_fit_circle(frames[f]);
+		best_fit_circle.set_verbose(false);
+		bool is_computable = best_fit_circle.compute_best_fit_circle();
+		full_costs.add_frame(truth[f].is_jump, std::chrono::duration<double>(Clock::now() - start).count(), best_fit_circle.get_iteration_count());
+		if (!is_computable)
+			++full_costs.failed;
+		else
+		{
+			Circle_Center center = best_fit_circle.get_center_coordinate();
+			full_costs.center_error += std::hypot(center.x - truth[f].center_x, center.y - truth[f].center_y);
+		}
+	}
+	full_costs.full_fits = frame_count;
+	print_row("full fit", full_costs);
+
+	// Warm started tracking
+	Circle_Tracker tracker;
+	Method_Costs tracking_costs;
+	for (size_t f = 0; f < frame_count; ++f) {
+		unsigned long long iterations = tracker.get_stats().iterations;
+		Clock::time_point start = Clock::now();
+		Fit_Result result = tracker.track(frames[f]);
+		tracking_costs.add_frame(truth[f].is_jump, std::chrono::duration<double>(Clock::now() - start).count(), tracker.get_stats().iterations - iterations);
+		if (!result.is_computable)
+			++tracking_costs.failed;
+		else
+			tracking_costs.center_error += std::hypot(result.center.x - truth[f].center_x, result.center.y - truth[f].center_y);
+	}
+	tracking_costs.full_fits = tracker.get_stats().full_fits;
+	print_row("tracking", tracking_costs);
+	if (frame_count >= 250 && tracking_costs.full_fits < 2)
+	{
+		std::cout << "The jumps did not make the tracker fall back to a full fit" << std::endl;
+		return 1;
+	}
+	return 0;
+}
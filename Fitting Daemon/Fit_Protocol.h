@@ -0,0 +1,97 @@
+/*
+* @file Fit_Protocol.h
+* @brief Binary protocol shared by the fitting daemon and its clients over a Unix domain socket.
+*
+* A request is a Fit_Request_Header followed by point_count pairs of int32 (x, y) coordinates.
+* The daemon answers every request with one Fit_Response on the same connection. Requests on a
+* connection are answered in order. Both ends run on the same host so fields use native byte order.
+*
+*/
+#include <cstdint>
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#pragma once
+#ifndef FIT_PROTOCOL
+#define FIT_PROTOCOL
+
+const uint32_t fit_request_magic = 0x43464954; // "CFIT"
+const uint32_t fit_response_magic = 0x52464954; // "RFIT"
+const uint32_t max_points_per_request = 1 << 20;
+const char* const default_socket_path = "/tmp/best_fit_circles.sock";
+
+enum Fit_Status : uint32_t {
+	fit_ok = 0,
+	fit_not_computable = 1,
+	fit_bad_request = 2
+};
+
+#pragma pack(push, 1)
+struct Fit_Request_Header {
+	uint32_t magic;
+	uint32_t request_id;
+	uint32_t point_count;
+};
+
+struct Fit_Response {
+	uint32_t magic;
+	uint32_t request_id;
+	uint32_t status;
+	uint32_t batch_size; // Number of requests fitted together with this one
+	double center_x;
+	double center_y;
+	double radius;
+	uint64_t queue_ns; // Time spent waiting for the batch to be dispatched
+	uint64_t fit_ns; // Time spent fitting the whole batch
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Fit_Request_Header) == 12, "Fit_Request_Header must be 12 bytes");
+static_assert(sizeof(Fit_Response) == 56, "Fit_Response must be 56 bytes");
+
+/**
+* Reads exactly size bytes from the socket
+*
+* @param fd Socket descriptor
+* @param buffer Destination buffer
+* @param size Number of bytes to read
+* @return true if all the bytes were read, false on error or end of stream
+*/
+inline bool read_fully(int fd, void* buffer, size_t size) {
+	char* data = static_cast<char*>(buffer);
+	while (size > 0) {
+		ssize_t received = recv(fd, data, size, 0);
+		if (received < 0 && errno == EINTR)
+			continue;
+		if (received <= 0)
+			return false;
+		data += received;
+		size -= received;
+	}
+	return true;
+}
+
+/**
+* Writes exactly size bytes to the socket without raising SIGPIPE if the peer has gone away
+*
+* @param fd Socket descriptor
+* @param buffer Source buffer
+* @param size Number of bytes to write
+* @return true if all the bytes were written
+*/
+inline bool write_fully(int fd, const void* buffer, size_t size) {
+	const char* data = static_cast<const char*>(buffer);
+	while (size > 0) {
+		ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent <= 0)
+			return false;
+		data += sent;
+		size -= sent;
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,295 @@
+/*
+* @file Fitting_Server.cpp
+* @brief Long running local service that fits best fit circles for other processes on the same host.
+*
+* Clients connect over a Unix domain socket and send requests in the binary format described in
+* Fit_Protocol.h. Requests arriving from all connections are queued and coalesced into batches that
+* are fitted together by Batch_Fitter, so the startup and OpenCV initialization cost is paid once.
+* A batch is dispatched once it holds max_batch requests or once its oldest request has waited
+* batch_window microseconds, whichever comes first.
+*
+* Memory stays bounded under overload: once the queued and in flight requests hold max_queued_points
+* points, readers stop reading from their sockets until a batch is done, and no more than
+* max_connections clients are served at a time, later ones wait in the listen backlog.
+*
+* Usage: Fitting_Server [socket_path] [threads] [max_batch] [batch_window_us] [max_connections] [max_queued_points]
+*
+*/
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <cstdlib>
+#include <sys/un.h>
+#include "Fit_Protocol.h"
+#include "../Toggle Points Method/Batch_Fitter.h"
+
+static_assert(sizeof(cv::Point) == 2 * sizeof(int32_t), "cv::Point must match the wire format");
+
+typedef std::chrono::steady_clock Clock;
+
+/*
+* A client connection. The socket is closed once the reader thread has finished and the last
+* queued request of the connection has been answered
+*/
+struct Connection {
+	int fd;
+	std::mutex write_mutex;
+	Connection(int fd) : fd(fd) {}
+	~Connection() { close(fd); }
+};
+
+struct Pending_Request {
+	std::shared_ptr<Connection> connection;
+	uint32_t request_id;
+	std::vector<cv::Point> points;
+	Clock::time_point received;
+};
+
+// Server settings
+const char* socket_path = default_socket_path;
+unsigned int thread_count = 0;
+size_t max_batch = 64;
+std::chrono::microseconds batch_window(200);
+unsigned int max_connections = 256;
+size_t max_queued_points = 1 << 24;
+
+// Queue of requests waiting for the batcher
+std::mutex queue_mutex;
+std::condition_variable queue_ready;
+std::condition_variable queue_space;
+std::deque<Pending_Request> pending;
+size_t queued_points = 0; // Points of the requests being read, queued or fitted
+
+// Number of clients being served
+std::mutex connection_mutex;
+std::condition_variable connection_closed;
+unsigned int connection_count = 0;
+
+/**
+* Removes the socket file when the server is interrupted so the next start can bind again
+*/
+void handle_shutdown(int) {
+	unlink(socket_path);
+	_exit(0);
+}
+
+/**
+* Sends a response on the connection. Writes are serialized per connection because the reader
+* thread answers malformed requests itself
+*
+* @param connection Connection to answer on
+* @param response Response to send
+* @return true if the response was sent
+*/
+bool send_response(Connection& connection, const Fit_Response& response) {
+	std::lock_guard<std::mutex> lock(connection.write_mutex);
+	return write_fully(connection.fd, &response, sizeof(response));
+}
+
+/**
+* Returns the points of finished or abandoned requests to the queue limit
+*
+* @param point_count Number of points released
+*/
+void release_queued_points(size_t point_count) {
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	queued_points -= point_count;
+	queue_space.notify_all();
+}
+
+/**
+* Reads requests from one client until it disconnects and queues them for the batcher. Before
+* reading the points of a request it waits until they fit in the queue limit, a request larger than
+* the whole limit waits for an empty queue
+*
+* @param connection Client connection
+*/
+void serve_connection(std::shared_ptr<Connection> connection) {
+	Fit_Request_Header header;
+	while (read_fully(connection->fd, &header, sizeof(header))) {
+		if (header.magic != fit_request_magic || header.point_count > max_points_per_request)
+		{
+			// The stream cannot be resynchronized after a malformed header
+			Fit_Response response;
+			std::memset(&response, 0, sizeof(response));
+			response.magic = fit_response_magic;
+			response.request_id = header.request_id;
+			response.status = fit_bad_request;
+			send_response(*connection, response);
+			break;
+		}
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex);
+			queue_space.wait(lock, [&] { return queued_points == 0 || queued_points + header.point_count <= max_queued_points; });
+			queued_points += header.point_count;
+		}
+		Pending_Request request;
+		request.connection = connection;
+		request.request_id = header.request_id;
+		request.points.resize(header.point_count);
+		if (!read_fully(connection->fd, request.points.data(), header.point_count * sizeof(cv::Point)))
+		{
+			release_queued_points(header.point_count);
+			break;
+		}
+		request.received = Clock::now();
+
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		pending.push_back(std::move(request));
+		if (pending.size() == 1 || pending.size() >= max_batch)
+			queue_ready.notify_one();
+	}
+
+	std::lock_guard<std::mutex> lock(connection_mutex);
+	--connection_count;
+	connection_closed.notify_one();
+}
+
+/**
+* Collects queued requests into batches, fits them in parallel and answers each request
+* with its result and timing
+*/
+void run_batcher() {
+	Batch_Fitter batch_fitter(thread_count);
+	std::vector<Pending_Request> batch;
+	std::vector<std::vector<cv::Point>> point_sets;
+
+	// Running totals printed periodically
+	unsigned long long total_requests = 0;
+	unsigned long long total_batches = 0;
+	double total_fit_seconds = 0.0;
+	Clock::time_point last_report = Clock::now();
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex);
+			queue_ready.wait(lock, [] { return !pending.empty(); });
+			// Give other clients until the batch window closes to join the batch
+			Clock::time_point deadline = pending.front().received + batch_window;
+			queue_ready.wait_until(lock, deadline, [] { return pending.size() >= max_batch; });
+
+			size_t batch_size = std::min(max_batch, pending.size());
+			batch.clear();
+			for (size_t i = 0; i < batch_size; ++i) {
+				batch.push_back(std::move(pending.front()));
+				pending.pop_front();
+			}
+		}
+
+		point_sets.clear();
+		size_t batch_points = 0;
+		for (auto& request : batch) {
+			batch_points += request.points.size();
+			point_sets.push_back(std::move(request.points));
+		}
+		Clock::time_point fit_start = Clock::now();
+		std::vector<Fit_Result> results = batch_fitter.fit(point_sets);
+		Clock::time_point fit_end = Clock::now();
+		point_sets.clear();
+		release_queued_points(batch_points);
+		uint64_t fit_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(fit_end - fit_start).count();
+
+		for (size_t i = 0; i < batch.size(); ++i) {
+			Fit_Response response;
+			response.magic = fit_response_magic;
+			response.request_id = batch[i].request_id;
+			response.status = results[i].is_computable ? fit_ok : fit_not_computable;
+			response.batch_size = (uint32_t)batch.size();
+			response.center_x = results[i].center.x;
+			response.center_y = results[i].center.y;
+			response.radius = results[i].radius;
+			response.queue_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(fit_start - batch[i].received).count();
+			response.fit_ns = fit_ns;
+			send_response(*batch[i].connection, response); // A client that went away is not an error
+		}
+		batch.clear(); // Release the connections held by this batch
+
+		total_requests += results.size();
+		++total_batches;
+		total_fit_seconds += fit_ns * 1.0e-9;
+		if (fit_end - last_report > std::chrono::seconds(5))
+		{
+			std::cout << "requests = " << total_requests << ", batches = " << total_batches
+				<< ", mean batch size = " << (double)total_requests / total_batches
+				<< ", fit time = " << total_fit_seconds << " s" << std::endl;
+			last_report = fit_end;
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc > 1)
+		socket_path = argv[1];
+	if (argc > 2)
+		thread_count = std::atoi(argv[2]);
+	if (argc > 3)
+		max_batch = std::max(1, std::atoi(argv[3]));
+	if (argc > 4)
+		batch_window = std::chrono::microseconds(std::atoi(argv[4]));
+	if (argc > 5)
+		max_connections = std::max(1, std::atoi(argv[5]));
+	if (argc > 6)
+		max_queued_points = std::strtoull(argv[6], nullptr, 10);
+
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (std::strlen(socket_path) >= sizeof(address.sun_path))
+	{
+		std::cout << "Socket path is too long" << std::endl;
+		return -1;
+	}
+	std::strcpy(address.sun_path, socket_path);
+
+	int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listen_fd < 0)
+	{
+		std::cout << "Could not create socket: " << std::strerror(errno) << std::endl;
+		return -1;
+	}
+	unlink(socket_path); // Remove a stale socket left by a previous run
+	if (bind(listen_fd, (sockaddr*)&address, sizeof(address)) < 0 || listen(listen_fd, 128) < 0)
+	{
+		std::cout << "Could not listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+		return -1;
+	}
+	std::signal(SIGINT, handle_shutdown);
+	std::signal(SIGTERM, handle_shutdown);
+
+	std::thread batcher(run_batcher);
+	batcher.detach();
+	std::cout << "Fitting server listening on " << socket_path << " (max batch = " << max_batch
+		<< ", batch window = " << batch_window.count() << " us, max connections = " << max_connections
+		<< ", max queued points = " << max_queued_points << ")" << std::endl;
+
+	while (true) {
+		{
+			// Clients beyond the limit wait in the listen backlog until a connection closes
+			std::unique_lock<std::mutex> lock(connection_mutex);
+			connection_closed.wait(lock, [] { return connection_count < max_connections; });
+		}
+		int client_fd = accept(listen_fd, nullptr, nullptr);
+		if (client_fd < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			std::cout << "Accept failed: " << std::strerror(errno) << std::endl;
+			break;
+		}
+		{
+			std::lock_guard<std::mutex> lock(connection_mutex);
+			++connection_count;
+		}
+		std::thread(serve_connection, std::make_shared<Connection>(client_fd)).detach();
+	}
+	unlink(socket_path);
+	return 0;
+}
@@ -0,0 +1,187 @@
+/*
+* @file Load_Generator.cpp
+* @brief Load generator for the fitting daemon. Runs a closed loop benchmark at increasing
+* concurrency levels where every client keeps one request in flight on its own connection, and
+* reports throughput and tail latency for each level.
+*
+* Usage: Load_Generator [socket_path] [requests_per_client] [points_per_request] [concurrency levels ...]
+*
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <sys/un.h>
+#include "Fit_Protocol.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct Client_Stats {
+	std::vector<double> latencies_us;
+	double queue_us = 0.0;
+	double batch_size = 0.0;
+	unsigned int failures = 0;
+};
+
+/**
+* Opens a connection to the fitting daemon
+*
+* @param socket_path Path of the daemon's socket
+* @return fd Socket descriptor, -1 if the daemon cannot be reached
+*/
+int connect_to_server(const char* socket_path) {
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd >= 0 && connect(fd, (sockaddr*)&address, sizeof(address)) < 0)
+	{
+		close(fd);
+		fd = -1;
+	}
+	return fd;
+}
+
+/**
+* Generates points scattered around a random circle, the kind of input the fitter sees from the grid
+*
+* @param generator Random number generator
+* @param point_count Number of points
+* @param points Output buffer of interleaved x and y coordinates
+*/
+void generate_points(std::mt19937& generator, unsigned int point_count, std::vector<int32_t>& points) {
+	std::uniform_real_distribution<double> center(200.0, 600.0);
+	std::uniform_real_distribution<double> radius(50.0, 200.0);
+	std::uniform_real_distribution<double> angle(0.0, 2 * 3.14159265358979);
+	std::normal_distribution<double> noise(0.0, 2.0);
+	double cx = center(generator), cy = center(generator), r = radius(generator);
+	points.resize(2 * point_count);
+	for (unsigned int i = 0; i < point_count; ++i) {
+		double theta = angle(generator);
+		points[2 * i] = (int32_t)std::lround(cx + (r + noise(generator)) * std::cos(theta));
+		points[2 * i + 1] = (int32_t)std::lround(cy + (r + noise(generator)) * std::sin(theta));
+	}
+}
+
+/**
+* Sends requests one after another on a single connection and records the round trip latency
+*
+* @param socket_path Path of the daemon's socket
+* @param client_id Seed for the point generator
+* @param request_count Number of requests to send
+* @param point_count Number of points in each request
+* @param stats Output statistics of this client
+*/
+void run_client(const char* socket_path, unsigned int client_id, unsigned int request_count, unsigned int point_count, Client_Stats* stats) {
+	int fd = connect_to_server(socket_path);
+	if (fd < 0)
+	{
+		stats->failures = request_count;
+		return;
+	}
+	std::mt19937 generator(client_id);
+	std::vector<int32_t> points;
+	stats->latencies_us.reserve(request_count);
+
+	for (unsigned int i = 0; i < request_count; ++i) {
+		generate_points(generator, point_count, points);
+		Fit_Request_Header header;
+		header.magic = fit_request_magic;
+		header.request_id = i;
+		header.point_count = point_count;
+		Fit_Response response;
+
+		Clock::time_point start = Clock::now();
+		bool ok = write_fully(fd, &header, sizeof(header))
+			&& write_fully(fd, points.data(), points.size() * sizeof(int32_t))
+			&& read_fully(fd, &response, sizeof(response));
+		Clock::time_point end = Clock::now();
+		if (!ok || response.magic != fit_response_magic || response.request_id != i)
+		{
+			stats->failures += request_count - i;
+			break;
+		}
+		if (response.status != fit_ok)
+			++stats->failures;
+		stats->latencies_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+		stats->queue_us += response.queue_ns * 1.0e-3;
+		stats->batch_size += response.batch_size;
+	}
+	close(fd);
+}
+
+/**
+* Returns the given percentile of a sorted list of latencies
+*
+* @param sorted Latencies sorted in ascending order
+* @param percentile Percentile between 0 and 100
+* @return latency at the percentile
+*/
+double percentile_of(const std::vector<double>& sorted, double percentile) {
+	if (sorted.empty())
+		return 0.0;
+	size_t index = (size_t)std::ceil(percentile / 100.0 * sorted.size());
+	return sorted[std::min(sorted.size() - 1, index > 0 ? index - 1 : 0)];
+}
+
+int main(int argc, char** argv) {
+	const char* socket_path = (argc > 1) ? argv[1] : default_socket_path;
+	unsigned int request_count = (argc > 2) ? std::atoi(argv[2]) : 2000;
+	unsigned int point_count = (argc > 3) ? std::atoi(argv[3]) : 16;
+	std::vector<unsigned int> concurrency_levels;
+	for (int i = 4; i < argc; ++i) {
+		concurrency_levels.push_back(std::atoi(argv[i]));
+	}
+	if (concurrency_levels.empty())
+		concurrency_levels = { 1, 2, 4, 8, 16, 32, 64 };
+
+	std::cout << "points per request = " << point_count << ", requests per client = " << request_count << std::endl;
+	std::cout << std::setw(8) << "clients" << std::setw(14) << "req/s" << std::setw(11) << "p50 us"
+		<< std::setw(11) << "p99 us" << std::setw(11) << "p99.9 us" << std::setw(11) << "max us"
+		<< std::setw(11) << "queue us" << std::setw(8) << "batch" << std::setw(10) << "failed" << std::endl;
+
+	for (unsigned int clients : concurrency_levels) {
+		std::vector<Client_Stats> stats(clients);
+		std::vector<std::thread> threads;
+		Clock::time_point start = Clock::now();
+		for (unsigned int c = 0; c < clients; ++c) {
+			threads.emplace_back(run_client, socket_path, c + 1, request_count, point_count, &stats[c]);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		// Merge the per client measurements
+		std::vector<double> latencies;
+		double queue_us = 0.0, batch_size = 0.0;
+		unsigned int failures = 0;
+		for (auto& client : stats) {
+			latencies.insert(latencies.end(), client.latencies_us.begin(), client.latencies_us.end());
+			queue_us += client.queue_us;
+			batch_size += client.batch_size;
+			failures += client.failures;
+		}
+		if (latencies.empty())
+		{
+			std::cout << "Could not reach the fitting server at " << socket_path << std::endl;
+			return -1;
+		}
+		std::sort(latencies.begin(), latencies.end());
+		std::cout << std::fixed << std::setprecision(1)
+			<< std::setw(8) << clients << std::setw(14) << latencies.size() / seconds
+			<< std::setw(11) << percentile_of(latencies, 50) << std::setw(11) << percentile_of(latencies, 99)
+			<< std::setw(11) << percentile_of(latencies, 99.9) << std::setw(11) << latencies.back()
+			<< std::setw(11) << queue_us / latencies.size() << std::setw(8) << batch_size / latencies.size()
+			<< std::setw(10) << failures << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,135 @@
+/*
+* @file Algebraic_Fit.cpp
+* @brief Source file for Algebraic_Fit which accumulates the sufficient statistics of an
+* algebraic least squares circle fit.
+*
+*/
+#include "Algebraic_Fit.h"
+#include <cmath>
+
+/**
+* Adds a point to the sums. Coordinates are taken relative to the first point to keep the
+* sums of powers small
+*
+* @param x x coordinate of the point
+* @param y y coordinate of the point
+*/
+void Algebraic_Fit::add(double x, double y) {
+	if (!has_origin)
+	{
+		origin_x = x;
+		origin_y = y;
+		has_origin = true;
+	}
+	double u = x - origin_x;
+	double v = y - origin_y;
+	double z = u * u + v * v;
+	n += 1;
+	su += u;
+	sv += v;
+	suu += u * u;
+	svv += v * v;
+	suv += u * v;
+	suz += u * z;
+	svz += v * z;
+	sz += z;
+}
+
+/**
+* Adds the sums of another accumulator, for example one filled by another thread. The other
+* sums are moved to this accumulator's origin first
+*
+* @param other Accumulator to merge
+*/
+void Algebraic_Fit::merge(const Algebraic_Fit& other) {
+	if (!other.has_origin)
+		return;
+	if (!has_origin)
+	{
+		*this = other;
+		return;
+	}
+	// Shift the other sums from their origin to this one: u' = u + p, v' = v + q
+	double p = other.origin_x - origin_x;
+	double q = other.origin_y - origin_y;
+	double pq = p * p + q * q;
+	double o_suu = other.suu + 2 * p * other.su + p * p * other.n;
+	double o_svv = other.svv + 2 * q * other.sv + q * q * other.n;
+	double o_suv = other.suv + p * other.sv + q * other.su + p * q * other.n;
+	double o_sz = other.sz + 2 * p * other.su + 2 * q * other.sv + pq * other.n;
+	double o_suz = other.suz + 2 * p * other.suu + 2 * q * other.suv + pq * other.su
+		+ p * other.sz + 2 * p * p * other.su + 2 * p * q * other.sv + p * pq * other.n;
+	double o_svz = other.svz + 2 * p * other.suv + 2 * q * other.svv + pq * other.sv
+		+ q * other.sz + 2 * q * p * other.su + 2 * q * q * other.sv + q * pq * other.n;
+	n += other.n;
+	su += other.su + p * other.n;
+	sv += other.sv + q * other.n;
+	suu += o_suu;
+	svv += o_svv;
+	suv += o_suv;
+	suz += o_suz;
+	svz += o_svz;
+	sz += o_sz;
+}
+
+/**
+* Solves the 3x3 normal equations for a, b and c with Cramer's rule, from the sums of points taken
+* relative to an origin. Shared with Arc_Segmenter, which keeps the same sums per segment
+*
+* @param n Number of points
+* @param su Sum of u
+* @param sv Sum of v
+* @param suu Sum of u^2
+* @param svv Sum of v^2
+* @param suv Sum of u v
+* @param sz Sum of z = u^2 + v^2
+* @param suz Sum of u z
+* @param svz Sum of v z
+* @param a Coefficient of u
+* @param b Coefficient of v
+* @param c Constant term
+* @return false if there are less than three points, they are all aligned or a, b or c is not finite
+*/
+bool Algebraic_Fit::solve_sums(double n, double su, double sv, double suu, double svv, double suv, double sz, double suz, double svz,
+	double& a, double& b, double& c) {
+	if (n < 3)
+		return false;
+	double det = suu * (svv * n - sv * sv) - suv * (suv * n - sv * su) + su * (suv * sv - svv * su);
+	// Relative to the scale of the sums, so points along an axis, with suu or svv zero, are still caught
+	double scale = (suu + svv) * (suu + svv) * n;
+	if (std::abs(det) <= 1.0e-12 * scale || det == 0)
+		return false; // Circle cannot be computed because all the points are aligned
+	double det_a = -suz * (svv * n - sv * sv) + suv * (svz * n - sv * sz) - su * (svz * sv - svv * sz);
+	double det_b = suu * (-svz * n + sv * sz) + suz * (suv * n - sv * su) + su * (-suv * sz + svz * su);
+	double det_c = suu * (-svv * sz + svz * sv) - suv * (-suv * sz + svz * su) - suz * (suv * sv - svv * su);
+	a = det_a / det;
+	b = det_b / det;
+	c = det_c / det;
+	return std::isfinite(a) && std::isfinite(b) && std::isfinite(c);
+}
+
+/**
+* Solves the normal equations of the points added so far
+*
+* @param center Center of the algebraic fit
+* @param radius Radius of the algebraic fit
+* @return false if there are less than three points, they are all aligned or the circle is not finite
+*/
+bool Algebraic_Fit::solve(Circle_Center& center, double& radius) {
+	double a, b, c;
+	if (!solve_sums(n, su, sv, suu, svv, suv, sz, suz, svz, a, b, c))
+		return false;
+	center.x = origin_x - a / 2;
+	center.y = origin_y - b / 2;
+	radius = sqrt(std::max(0.0, a * a / 4 + b * b / 4 - c));
+	return std::isfinite(center.x) && std::isfinite(center.y) && std::isfinite(radius);
+}
+
+/**
+* returns the number of points added
+*
+* @return n Point count
+*/
+double Algebraic_Fit::get_count() {
+	return n;
+}
@@ -0,0 +1,31 @@
+/*
+* @file Algebraic_Fit.h
+* @brief Header file for Algebraic_Fit which accumulates the sufficient statistics of an
+* algebraic least squares circle fit. It minimizes the sum of (x^2 + y^2 + a x + b y + c)^2,
+* which is linear in a, b and c, so a single pass over the points gives a good initial estimate
+* for the geometric fit without the point triplet initializer.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+
+#pragma once
+#ifndef ALGEBRAIC_FIT
+#define ALGEBRAIC_FIT
+
+class Algebraic_Fit
+{
+private:
+	bool has_origin = false;
+	double origin_x = 0.0, origin_y = 0.0;
+	double n = 0, su = 0, sv = 0, suu = 0, svv = 0, suv = 0, suz = 0, svz = 0, sz = 0;
+public:
+
+	void add(double x, double y);
+	void merge(const Algebraic_Fit&);
+	bool solve(Circle_Center&, double&);
+	double get_count();
+	static bool solve_sums(double n, double su, double sv, double suu, double svv, double suv, double sz, double suz, double svz,
+		double& a, double& b, double& c);
+};
+#endif
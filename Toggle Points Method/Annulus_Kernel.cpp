@@ -0,0 +1,306 @@
+/*
+* @file Annulus_Kernel.cpp
+* @brief Source file for the annulus kernel, the inner loop of Annulus_Query. Every version computes
+* the squared distance of each point to the center, compares it against the squared bounds and
+* appends the index and squared distance of the points that pass to the output arrays. None of them
+* branch on whether a point passes, so a wide annulus costs the same as a thin one.
+*
+*/
+#include "Annulus_Kernel.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ANNULUS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// Lets a function use the instructions of an ISA without compiling the whole file for it
+#if defined(ANNULUS_X86) && defined(__GNUC__)
+#define ANNULUS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ANNULUS_TARGET(isa)
+#endif
+
+/**
+* Number of set bits of a lane mask
+*/
+static inline size_t get_lane_count(unsigned int mask) {
+#if defined(_MSC_VER)
+	return __popcnt(mask);
+#else
+	return (size_t)__builtin_popcount(mask);
+#endif
+}
+
+/**
+* Scalar kernel, also used for the points left over after the last full vector. Every point is
+* written to the output and the output position only advances when it passes, so there is no branch
+*/
+static size_t find_annulus_points_scalar(const double* xs, const double* ys, size_t begin, size_t count, double center_x, double center_y,
+	double lower_squared, double upper_squared, uint32_t* indices, double* squared_distances, size_t found) {
+	for (size_t i = begin; i < count; ++i) {
+		double dx = xs[i] - center_x;
+		double dy = ys[i] - center_y;
+		double squared_distance = dx * dx + dy * dy;
+		indices[found] = (uint32_t)i;
+		squared_distances[found] = squared_distance;
+		found += (squared_distance >= lower_squared) & (squared_distance <= upper_squared);
+	}
+	return found;
+}
+
+#ifdef ANNULUS_X86
+/**
+* SSE2 kernel, two points per vector
+*/
+ANNULUS_TARGET("sse2")
+static size_t find_annulus_points_sse2(const double* xs, const double* ys, size_t count, double center_x, double center_y,
+	double lower_squared, double upper_squared, uint32_t* indices, double* squared_distances) {
+	const __m128d cx = _mm_set1_pd(center_x), cy = _mm_set1_pd(center_y);
+	const __m128d lower = _mm_set1_pd(lower_squared), upper = _mm_set1_pd(upper_squared);
+	size_t found = 0;
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2) {
+		__m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), cx);
+		__m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), cy);
+		__m128d squared_distance = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+		unsigned int mask = (unsigned int)_mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(squared_distance, lower), _mm_cmple_pd(squared_distance, upper)));
+		double lanes[2];
+		_mm_storeu_pd(lanes, squared_distance);
+		for (int lane = 0; lane < 2; ++lane) { // Same write pattern as the scalar kernel, no branch per lane
+			indices[found] = (uint32_t)(i + lane);
+			squared_distances[found] = lanes[lane];
+			found += (mask >> lane) & 1;
+		}
+	}
+	return find_annulus_points_scalar(xs, ys, i, count, center_x, center_y, lower_squared, upper_squared, indices, squared_distances, found);
+}
+
+// For each AVX2 lane mask, the 32 bit halves of the kept doubles moved to the front
+alignas(32) static const int32_t avx2_compress_permutations[16][8] = {
+	{ 0, 0, 0, 0, 0, 0, 0, 0 },
+	{ 0, 1, 0, 0, 0, 0, 0, 0 },
+	{ 2, 3, 0, 0, 0, 0, 0, 0 },
+	{ 0, 1, 2, 3, 0, 0, 0, 0 },
+	{ 4, 5, 0, 0, 0, 0, 0, 0 },
+	{ 0, 1, 4, 5, 0, 0, 0, 0 },
+	{ 2, 3, 4, 5, 0, 0, 0, 0 },
+	{ 0, 1, 2, 3, 4, 5, 0, 0 },
+	{ 6, 7, 0, 0, 0, 0, 0, 0 },
+	{ 0, 1, 6, 7, 0, 0, 0, 0 },
+	{ 2, 3, 6, 7, 0, 0, 0, 0 },
+	{ 0, 1, 2, 3, 6, 7, 0, 0 },
+	{ 4, 5, 6, 7, 0, 0, 0, 0 },
+	{ 0, 1, 4, 5, 6, 7, 0, 0 },
+	{ 2, 3, 4, 5, 6, 7, 0, 0 },
+	{ 0, 1, 2, 3, 4, 5, 6, 7 }
+};
+
+// For each AVX2 lane mask, the kept lanes in order
+alignas(16) static const int32_t avx2_compress_lanes[16][4] = {
+	{ 0, 0, 0, 0 },
+	{ 0, 0, 0, 0 },
+	{ 1, 0, 0, 0 },
+	{ 0, 1, 0, 0 },
+	{ 2, 0, 0, 0 },
+	{ 0, 2, 0, 0 },
+	{ 1, 2, 0, 0 },
+	{ 0, 1, 2, 0 },
+	{ 3, 0, 0, 0 },
+	{ 0, 3, 0, 0 },
+	{ 1, 3, 0, 0 },
+	{ 0, 1, 3, 0 },
+	{ 2, 3, 0, 0 },
+	{ 0, 2, 3, 0 },
+	{ 1, 2, 3, 0 },
+	{ 0, 1, 2, 3 }
+};
+
+/**
+* AVX2 kernel, four points per vector. AVX2 has no compress store, so the kept lanes are moved to
+* the front with a permutation looked up from the lane mask and the whole vector is stored; the
+* output position then advances by the number of kept lanes
+*/
+ANNULUS_TARGET("avx2")
+static size_t find_annulus_points_avx2(const double* xs, const double* ys, size_t count, double center_x, double center_y,
+	double lower_squared, double upper_squared, uint32_t* indices, double* squared_distances) {
+	const __m256d cx = _mm256_set1_pd(center_x), cy = _mm256_set1_pd(center_y);
+	const __m256d lower = _mm256_set1_pd(lower_squared), upper = _mm256_set1_pd(upper_squared);
+	size_t found = 0;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), cx);
+		__m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), cy);
+		__m256d squared_distance = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+		__m256d in_annulus = _mm256_and_pd(_mm256_cmp_pd(squared_distance, lower, _CMP_GE_OQ), _mm256_cmp_pd(squared_distance, upper, _CMP_LE_OQ));
+		unsigned int mask = (unsigned int)_mm256_movemask_pd(in_annulus);
+		__m256i permutation = _mm256_load_si256((const __m256i*)avx2_compress_permutations[mask]);
+		__m128i index = _mm_add_epi32(_mm_set1_epi32((int)i), _mm_load_si128((const __m128i*)avx2_compress_lanes[mask]));
+		_mm256_storeu_pd(squared_distances + found, _mm256_castsi256_pd(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(squared_distance), permutation)));
+		_mm_storeu_si128((__m128i*)(indices + found), index);
+		found += get_lane_count(mask);
+	}
+	return find_annulus_points_scalar(xs, ys, i, count, center_x, center_y, lower_squared, upper_squared, indices, squared_distances, found);
+}
+
+/**
+* AVX-512 kernel, eight points per vector. The passing lanes are written with compress stores and
+* the last partial vector is handled with masked loads
+*/
+ANNULUS_TARGET("avx512f,avx512vl")
+static size_t find_annulus_points_avx512(const double* xs, const double* ys, size_t count, double center_x, double center_y,
+	double lower_squared, double upper_squared, uint32_t* indices, double* squared_distances) {
+	const __m512d cx = _mm512_set1_pd(center_x), cy = _mm512_set1_pd(center_y);
+	const __m512d lower = _mm512_set1_pd(lower_squared), upper = _mm512_set1_pd(upper_squared);
+	const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	size_t found = 0;
+	for (size_t i = 0; i < count; i += 8) {
+		__mmask8 valid = (count - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (count - i)) - 1);
+		__m512d dx = _mm512_sub_pd(_mm512_maskz_loadu_pd(valid, xs + i), cx);
+		__m512d dy = _mm512_sub_pd(_mm512_maskz_loadu_pd(valid, ys + i), cy);
+		__m512d squared_distance = _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+		__mmask8 mask = _mm512_mask_cmp_pd_mask(valid, squared_distance, lower, _CMP_GE_OQ);
+		mask = _mm512_mask_cmp_pd_mask(mask, squared_distance, upper, _CMP_LE_OQ);
+		__m256i index = _mm256_add_epi32(_mm256_set1_epi32((int)i), lane_offsets);
+		_mm256_mask_compressstoreu_epi32(indices + found, mask, index);
+		_mm512_mask_compressstoreu_pd(squared_distances + found, mask, squared_distance);
+		found += get_lane_count(mask);
+	}
+	return found;
+}
+#endif
+
+/**
+* Checks whether the processor and the operating system support an ISA
+*
+* @param isa Instruction set
+* @return true if the kernel for the ISA can run
+*/
+bool is_annulus_isa_supported(Annulus_Isa isa) {
+	if (isa == annulus_scalar)
+		return true;
+#if defined(ANNULUS_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	switch (isa) {
+	case annulus_sse2:
+		return __builtin_cpu_supports("sse2");
+	case annulus_avx2:
+		return __builtin_cpu_supports("avx2");
+	case annulus_avx512:
+		return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl");
+	default:
+		return false;
+	}
+#elif defined(ANNULUS_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	bool os_saves_ymm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 0x06) == 0x06);
+	bool os_saves_zmm = os_saves_ymm && ((_xgetbv(0) & 0xE0) == 0xE0);
+	__cpuidex(info, 7, 0);
+	switch (isa) {
+	case annulus_sse2:
+		return true; // Part of x86-64
+	case annulus_avx2:
+		return os_saves_ymm && (info[1] & (1 << 5));
+	case annulus_avx512:
+		return os_saves_zmm && (info[1] & (1 << 16)) && (info[1] & (1 << 31));
+	default:
+		return false;
+	}
+#else
+	return false;
+#endif
+}
+
+/**
+* returns the widest ISA supported by the processor
+*
+* @return isa Instruction set
+*/
+Annulus_Isa get_best_annulus_isa() {
+	if (is_annulus_isa_supported(annulus_avx512))
+		return annulus_avx512;
+	if (is_annulus_isa_supported(annulus_avx2))
+		return annulus_avx2;
+	if (is_annulus_isa_supported(annulus_sse2))
+		return annulus_sse2;
+	return annulus_scalar;
+}
+
+/**
+* returns the name of an ISA
+*
+* @param isa Instruction set
+* @return name Name of the instruction set
+*/
+const char* get_annulus_isa_name(Annulus_Isa isa) {
+	switch (isa) {
+	case annulus_sse2:
+		return "sse2";
+	case annulus_avx2:
+		return "avx2";
+	case annulus_avx512:
+		return "avx512";
+	default:
+		return "scalar";
+	}
+}
+
+/**
+* Computes squared bounds that keep exactly the points whose rounded distance, the square root of
+* the squared distance, lies in [lower, upper]. Squaring the bounds alone can be off by an ulp and
+* flip points that sit on the boundary, so each square is moved to the last value that still agrees
+*
+* @param lower Inner radius of the annulus
+* @param upper Outer radius of the annulus
+* @param lower_squared Smallest squared distance whose root is at least lower
+* @param upper_squared Largest squared distance whose root is at most upper
+*/
+void get_annulus_squared_bounds(double lower, double upper, double& lower_squared, double& upper_squared) {
+	lower_squared = lower * lower;
+	while (lower_squared > 0.0 && std::sqrt(std::nextafter(lower_squared, 0.0)) >= lower)
+		lower_squared = std::nextafter(lower_squared, 0.0);
+	while (std::sqrt(lower_squared) < lower)
+		lower_squared = std::nextafter(lower_squared, HUGE_VAL);
+
+	upper_squared = upper * upper;
+	while (std::sqrt(std::nextafter(upper_squared, HUGE_VAL)) <= upper)
+		upper_squared = std::nextafter(upper_squared, HUGE_VAL);
+	while (upper_squared > 0.0 && std::sqrt(upper_squared) > upper)
+		upper_squared = std::nextafter(upper_squared, 0.0);
+}
+
+/**
+* Finds the points whose squared distance to the center lies in [lower_squared, upper_squared]
+*
+* @param xs x coordinates of the points
+* @param ys y coordinates of the points
+* @param count Number of points
+* @param center_x x coordinate of the center
+* @param center_y y coordinate of the center
+* @param lower_squared Square of the inner radius of the annulus
+* @param upper_squared Square of the outer radius of the annulus
+* @param indices Indices of the points found, room for count entries is needed
+* @param squared_distances Squared distances of the points found, room for count entries is needed
+* @param isa Instruction set to use, it has to be supported
+* @return found Number of points found
+*/
+size_t find_annulus_points(const double* xs, const double* ys, size_t count, double center_x, double center_y,
+	double lower_squared, double upper_squared, uint32_t* indices, double* squared_distances, Annulus_Isa isa) {
+#ifdef ANNULUS_X86
+	switch (isa) {
+	case annulus_sse2:
+		return find_annulus_points_sse2(xs, ys, count, center_x, center_y, lower_squared, upper_squared, indices, squared_distances);
+	case annulus_avx2:
+		return find_annulus_points_avx2(xs, ys, count, center_x, center_y, lower_squared, upper_squared, indices, squared_distances);
+	case annulus_avx512:
+		return find_annulus_points_avx512(xs, ys, count, center_x, center_y, lower_squared, upper_squared, indices, squared_distances);
+	default:
+		break;
+	}
+#endif
+	return find_annulus_points_scalar(xs, ys, 0, count, center_x, center_y, lower_squared, upper_squared, indices, squared_distances, 0);
+}
@@ -0,0 +1,35 @@
+/*
+* @file Annulus_Kernel.h
+* @brief Header file for the annulus kernel, the inner loop of Annulus_Query. It scans points stored
+* as separate x and y arrays and keeps those whose squared distance to a center lies between two
+* squared bounds, so no square root is taken in the loop. The kept points are written as a compact
+* list of indices and squared distances. get_annulus_squared_bounds squares the radii so that the
+* kernel keeps the same points as comparing square roots against them would.
+*
+* The kernel is compiled for several instruction sets in the same binary: scalar, SSE2, AVX2 and
+* AVX-512 on x86-64. Each vector version compares a whole vector of points at once and writes out
+* only the lanes that pass. get_best_annulus_isa picks the widest one the processor supports.
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#pragma once
+#ifndef ANNULUS_KERNEL
+#define ANNULUS_KERNEL
+
+enum Annulus_Isa {
+	annulus_scalar,
+	annulus_sse2,
+	annulus_avx2,
+	annulus_avx512
+};
+
+bool is_annulus_isa_supported(Annulus_Isa);
+Annulus_Isa get_best_annulus_isa();
+const char* get_annulus_isa_name(Annulus_Isa);
+void get_annulus_squared_bounds(double lower, double upper, double& lower_squared, double& upper_squared);
+size_t find_annulus_points(const double* xs, const double* ys, size_t count, double center_x, double center_y,
+	double lower_squared, double upper_squared, uint32_t* indices, double* squared_distances, Annulus_Isa isa);
+#endif
@@ -0,0 +1,186 @@
+/*
+* @file Annulus_Query.cpp
+* @brief Source file for Annulus_Query, the computations behind the Radius Drag method: the grid
+* points that lie within a threshold of a user drawn circle, and the inner and outer threshold
+* circles around them. The distance test runs in the annulus kernel on squared distances, and only
+* the points found get a square root.
+*
+*/
+#include "Annulus_Query.h"
+#include <cmath>
+#include <cstdlib>
+
+/**
+* Constructor to setup the grid that is queried
+*
+* @param grid Grid of points, which has to outlive the query
+*
+*/
+Annulus_Query::Annulus_Query(const Grid_Model& grid) : grid(grid) {
+	int grid_size = grid.get_grid_size();
+	xs.resize((size_t)grid_size * grid_size);
+	ys.resize((size_t)grid_size * grid_size);
+	for (int i = 0; i < grid_size; ++i) {
+		for (int j = 0; j < grid_size; ++j) {
+			const cv::Point& point = grid.get_grid_point(i, j).point;
+			xs[(size_t)i * grid_size + j] = point.x;
+			ys[(size_t)i * grid_size + j] = point.y;
+		}
+	}
+	found_indices.resize(grid_size);
+	found_squared_distances.resize(grid_size);
+	isa = get_best_annulus_isa();
+}
+
+/**
+* Sets the instruction set of the annulus kernel, the widest supported one is used by default
+*
+* @param isa Instruction set, scalar is used if the processor does not support it
+*/
+void Annulus_Query::set_isa(Annulus_Isa isa) {
+	this->isa = is_annulus_isa_supported(isa) ? isa : annulus_scalar;
+}
+
+/**
+* returns the instruction set of the annulus kernel
+*
+* @return isa Instruction set
+*/
+Annulus_Isa Annulus_Query::get_isa() const {
+	return isa;
+}
+
+/**
+ * Calculates the x or y starting index of the grid to start checking for best fit points
+ *
+ * Finds the closest x or y point that is closest to the top left of the circle
+ *
+ * @param center_coordinate x or y coordinate of the circle's center
+ * @param radius radius of the circle
+ * @return start_indx x or y index of the top left location
+ */
+int Annulus_Query::get_start_indx(int center_coordinate, int radius) const {
+	int grid_spacing = (int)grid.get_grid_spacing();
+	int start_indx = center_coordinate - radius;
+	start_indx -= start_indx % grid_spacing; //top left x or y point closest to the circle
+	if (start_indx < grid_spacing) // Only points in the grid are selected
+	{
+		start_indx = grid_spacing;
+	}
+	return start_indx;
+}
+
+/**
+ * Calculates the x or y ending index of the grid to start checking for best fit points
+ *
+ * Finds the closest x or y point that is closest to the bottom of the circle
+ *
+ * @param start_indx x or y starting index
+ * @param radius radius of the circle
+ * @return end_indx x or y index of the bottom right location
+ */
+int Annulus_Query::get_end_indx(int start_indx, int radius) const {
+	int grid_spacing = (int)grid.get_grid_spacing();
+	int end_indx = start_indx + (radius << 1);
+	end_indx = end_indx + (grid_spacing - (end_indx % grid_spacing)); // bottom right x or y point closest to the circle
+	if (end_indx > grid_spacing * grid.get_grid_size()) { // Only points in the grid are selected
+		end_indx = grid_spacing * grid.get_grid_size();
+	}
+	return end_indx;
+}
+
+/**
+* Computes the best fit points given a circle and the distances between the best fit points and circle center
+*
+* Starts off by computing the indicies required to only account for points that are close to the circle. Each column of those
+* points is passed to the annulus kernel, which compares the squared distances against the squared threshold limits, and only
+* the points it finds get their distance computed.
+*
+* @param center_x x coordinate of the circle center
+* @param center_y y coordinate of the circle center
+* @param radius radius of the circle
+* @param threshold Check to see if the distance between the point is within a certain threshold to be considered as best fit
+* @return best_fit_points Grid position and distance to the center of each best fit point
+*/
+std::vector<Annulus_Point> Annulus_Query::get_best_fit_points(unsigned int center_x, unsigned int center_y, double radius, int threshold) const {
+	int grid_spacing = (int)grid.get_grid_spacing();
+	int grid_size = grid.get_grid_size();
+	// Calculate the start and end indicies of nearby points
+	int start_indx_x = get_start_indx(center_x, (int)radius);
+	int start_indx_y = get_start_indx(center_y, (int)radius);
+	int end_indx_x = get_end_indx(start_indx_x, (int)radius);
+	int end_indx_y = get_end_indx(start_indx_y, (int)radius);
+
+	std::vector<Annulus_Point> best_fit_points;
+	int first_row = start_indx_y / grid_spacing - 1;
+	int last_row = end_indx_y / grid_spacing - 1;
+	if (last_row < first_row)
+		return best_fit_points;
+	size_t row_count = (size_t)(last_row - first_row + 1);
+	double lower_squared;
+	double upper_squared;
+	get_annulus_squared_bounds(std::abs(radius - threshold), std::abs(radius + threshold), lower_squared, upper_squared);
+	// Loop through the columns of nearby points to check for best fitting points.
+	for (int i = start_indx_x / grid_spacing - 1; i <= end_indx_x / grid_spacing - 1; ++i) {
+		size_t column_start = (size_t)i * grid_size + first_row;
+		size_t found = find_annulus_points(&xs[column_start], &ys[column_start], row_count, (double)center_x, (double)center_y,
+			lower_squared, upper_squared, found_indices.data(), found_squared_distances.data(), isa);
+		for (size_t k = 0; k < found; ++k) {
+			best_fit_points.push_back({ i, first_row + (int)found_indices[k], std::sqrt(found_squared_distances[k]) });
+		}
+	}
+	return best_fit_points;
+}
+
+/**
+*
+* Calculate the inner and outer circle that the best points can fit
+*
+* @param distances Distances between the best fit points and the circle center
+* @param radius radius of the circle
+* @param threshold Check to see if the distance between the point is within a certain threshold to be considered as best fit
+* @param increment increment for the radius
+* @param inner_radius Radius of the inner threshold circle
+* @param outer_radius Radius of the outer threshold circle
+*/
+void Annulus_Query::compute_threshold_radii(const std::vector<double>& distances, double radius, int threshold, double increment,
+	double& inner_radius, double& outer_radius) {
+	size_t inner_count;
+	size_t outer_count;
+	inner_radius = radius;
+	outer_radius = radius;
+	bool found_inner_radius = false;
+	bool found_outer_radius = false;
+	if (distances.empty())
+		return; // No best fit points to bound
+
+	// Loop until best inner or outer circle is found
+	while (!found_inner_radius && !found_outer_radius) {
+		if (!found_inner_radius)
+			inner_radius -= increment;//increament the inner circle's radius by given increment
+		if (!found_outer_radius)
+			outer_radius += increment; //increament the outer circle's radius by given increment
+
+		inner_count = 0;
+		outer_count = 0;
+		// Interate between the distances to check if all the distances fall within a threshold
+		for (auto distance : distances) {
+			if (distance >= std::abs(inner_radius - threshold) && distance <= std::abs(inner_radius + threshold))
+			{
+				++inner_count;
+			}
+			if (inner_count <= distances.size() - 1)
+			{
+				found_inner_radius = true; //if at least one of the points dont fit, the radius is found
+			}
+			if (distance >= std::abs(outer_radius - threshold) && distance <= std::abs(outer_radius + threshold))
+			{
+				++outer_count;
+			}
+			if (outer_count <= distances.size() - 1)
+			{
+				found_outer_radius = true; //if at least one of the points dont fit, the radius is found
+			}
+		}
+	}
+}
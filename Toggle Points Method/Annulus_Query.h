@@ -0,0 +1,47 @@
+/*
+* @file Annulus_Query.h
+* @brief Header file for Annulus_Query, the computations behind the Radius Drag method: the grid
+* points that lie within a threshold of a user drawn circle, and the inner and outer threshold
+* circles around them. Nothing is drawn here, the front end draws the results.
+*
+* The grid coordinates are copied into separate x and y arrays, column by column, so each column
+* of the bounding box is one contiguous run for the annulus kernel.
+*
+*/
+
+#include "Grid_Model.h"
+#include "Annulus_Kernel.h"
+#include <vector>
+
+#pragma once
+#ifndef ANNULUS_QUERY
+#define ANNULUS_QUERY
+
+struct Annulus_Point {
+	int i; // Column of the grid point
+	int j; // Row of the grid point
+	double distance; // Distance to the circle's center
+};
+
+class Annulus_Query
+{
+private:
+	const Grid_Model& grid;
+	std::vector<double> xs; // Column by column, like the grid points
+	std::vector<double> ys;
+	Annulus_Isa isa;
+	mutable std::vector<uint32_t> found_indices; // Kernel output, reused between queries
+	mutable std::vector<double> found_squared_distances;
+
+	int get_start_indx(int center_coordinate, int radius) const;
+	int get_end_indx(int start_indx, int radius) const;
+public:
+
+	Annulus_Query(const Grid_Model&);
+	void set_isa(Annulus_Isa);
+	Annulus_Isa get_isa() const;
+	std::vector<Annulus_Point> get_best_fit_points(unsigned int center_x, unsigned int center_y, double radius, int threshold) const;
+	static void compute_threshold_radii(const std::vector<double>& distances, double radius, int threshold, double increment,
+		double& inner_radius, double& outer_radius);
+};
+#endif
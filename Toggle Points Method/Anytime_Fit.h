@@ -0,0 +1,57 @@
+/*
+* @file Anytime_Fit.h
+* @brief Runs the anytime fit of Best_Fitting_Circle::compute_anytime_fit on a Hypersphere_Fitter at
+* D = 2 over any point source. The center starts from the single sweep algebraic fit and the
+* reducing method stops as soon as a limit of the budget is reached. If the engine stops with
+* stopped_failed, because its points could not be read or the cost could not be evaluated, the
+* result is not computable.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include "Hypersphere_Fitter.h"
+#include <cmath>
+
+#pragma once
+#ifndef ANYTIME_FIT
+#define ANYTIME_FIT
+
+/**
+* Fits the circle within a budget
+*
+* @param engine Fitter over the points
+* @param budget Limits of the fit
+* @param start Time the fit started, the time budget counts from it
+* @param step_tolerance Stop once a step would move the center less than this, 0 to disable
+* @return result Best circle, whether it converged, why it stopped, its RMS residual and steps
+*/
+template <typename Points>
+inline Anytime_Result run_anytime_fit(Hypersphere_Fitter<2, Points>& engine, const Fit_Budget& budget,
+	std::chrono::steady_clock::time_point start, double step_tolerance) {
+	Anytime_Result result;
+	result.fit.center.x = 0.0;
+	result.fit.center.y = 0.0;
+	result.fit.radius = 0.0;
+	result.fit.is_computable = false;
+	result.converged = false;
+	result.stop = stopped_failed;
+	result.rms = 0.0;
+	result.iteration_count = 0;
+
+	engine.set_step_tolerance(step_tolerance);
+	engine.set_budget(budget, start);
+	if (engine.get_point_count() < 3 || !engine.initial_estimate())
+		return result;
+	result.converged = engine.refine_best_fit_sphere(engine.get_center());
+	result.stop = engine.get_stop_reason();
+	result.iteration_count = engine.get_iteration_count();
+	if (result.stop == stopped_failed)
+		return result;
+	result.fit.center.x = engine.get_center()[0];
+	result.fit.center.y = engine.get_center()[1];
+	result.fit.radius = engine.get_radius();
+	result.fit.is_computable = true;
+	result.rms = sqrt(engine.get_cost() / engine.get_point_count());
+	return result;
+}
+#endif
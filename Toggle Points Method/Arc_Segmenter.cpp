@@ -0,0 +1,306 @@
+/*
+* @file Arc_Segmenter.cpp
+* @brief Source file for Arc_Segmenter which splits an ordered contour into maximal arc and line
+* segments.
+*
+* The arc of a segment is the algebraic fit x^2 + y^2 + a x + b y + c = 0 of Algebraic_Fit, and its
+* line is the main axis of the points' covariance. Both only need the sums of Arc_Sums, and at the
+* solution of the normal equations the sum of the squared algebraic residuals is
+*
+*     sum z^2 + a sum u z + b sum v z + c sum z
+*
+* Near the arc an algebraic residual is about 2 r times the distance to the arc, which gives the
+* RMS distance of a segment in O(1) from the prefix sums as well.
+*
+*/
+#include "Arc_Segmenter.h"
+#include "Algebraic_Fit.h"
+#include <algorithm>
+#include <limits>
+
+/**
+* Constructor to copy the points into the structure of arrays buffer
+*
+* @param points Points of the contour in order
+*
+*/
+Arc_Segmenter::Arc_Segmenter(const std::vector<cv::Point>& points) {
+	xs.resize(points.size());
+	ys.resize(points.size());
+	for (size_t i = 0; i < points.size(); ++i) {
+		xs[i] = points[i].x;
+		ys[i] = points[i].y;
+	}
+	this->tolerance = 0.5;
+	this->max_deviation = 1.5;
+	this->min_points = 8;
+	this->fit_count = 0;
+	this->check_count = 0;
+}
+Arc_Segmenter::Arc_Segmenter(const std::vector<cv::Point2d>& points) {
+	xs.resize(points.size());
+	ys.resize(points.size());
+	for (size_t i = 0; i < points.size(); ++i) {
+		xs[i] = points[i].x;
+		ys[i] = points[i].y;
+	}
+	this->tolerance = 0.5;
+	this->max_deviation = 1.5;
+	this->min_points = 8;
+	this->fit_count = 0;
+	this->check_count = 0;
+}
+
+/**
+* Sets how closely a segment has to fit its points
+*
+* @param tolerance Largest RMS distance of the points to the arc or line
+* @param max_deviation Largest distance of any point to the arc or line, 0 does not check it
+*/
+void Arc_Segmenter::set_tolerance(double tolerance, double max_deviation) {
+	this->tolerance = tolerance;
+	this->max_deviation = max_deviation;
+}
+
+/**
+* Sets the number of points a segment starts with. Only the last segment of the contour can be
+* shorter. Where even this many points do not fit, the segment keeps them anyway and is marked
+* with within_tolerance false
+*
+* @param min_points Minimum number of points of a segment, at least 3
+*/
+void Arc_Segmenter::set_min_points(size_t min_points) {
+	this->min_points = std::max(min_points, (size_t)3);
+}
+
+/**
+* Adds points to the prefix sums of the segment starting at first until they hold point_count points
+*
+* @param first Index of the first point of the segment
+* @param point_count Number of points the prefix sums have to hold
+*/
+void Arc_Segmenter::extend_prefix_sums(size_t first, size_t point_count) {
+	if (prefix_sums.empty())
+		prefix_sums.push_back(Arc_Sums());
+	double origin_x = xs[first];
+	double origin_y = ys[first];
+	for (size_t k = prefix_sums.size() - 1; k < point_count; ++k) {
+		Arc_Sums sums = prefix_sums.back();
+		double u = xs[first + k] - origin_x;
+		double v = ys[first + k] - origin_y;
+		double z = u * u + v * v;
+		sums.su += u;
+		sums.sv += v;
+		sums.suu += u * u;
+		sums.svv += v * v;
+		sums.suv += u * v;
+		sums.sz += z;
+		sums.suz += u * z;
+		sums.svz += v * z;
+		sums.szz += z * z;
+		prefix_sums.push_back(sums);
+	}
+}
+
+/**
+* Fits an arc and a line to the first points of the segment from the prefix sums, and keeps the line
+* if it is within the tolerance or fits better than the arc
+*
+* @param first Index of the first point of the segment
+* @param point_count Number of points of the segment
+* @return segment Fitted segment, without its largest deviation
+*/
+Arc_Segment Arc_Segmenter::fit_segment(size_t first, size_t point_count) {
+	extend_prefix_sums(first, point_count);
+	++fit_count;
+	const Arc_Sums& s = prefix_sums[point_count];
+	double n = (double)point_count;
+	double origin_x = xs[first];
+	double origin_y = ys[first];
+
+	Arc_Segment segment;
+	segment.first = first;
+	segment.last = first + point_count - 1;
+	segment.max_deviation = 0.0;
+	segment.within_tolerance = false;
+
+	// Line through the centroid along the main axis, its RMS distance is the root of the smaller eigenvalue
+	double mean_u = s.su / n, mean_v = s.sv / n;
+	double cuu = std::max(0.0, s.suu / n - mean_u * mean_u);
+	double cvv = std::max(0.0, s.svv / n - mean_v * mean_v);
+	double cuv = s.suv / n - mean_u * mean_v;
+	double spread = std::sqrt((cuu - cvv) * (cuu - cvv) / 4 + cuv * cuv);
+	double line_rms = std::sqrt(std::max(0.0, (cuu + cvv) / 2 - spread));
+	double angle = std::atan2(2 * cuv, cuu - cvv) / 2;
+	segment.line_point = cv::Point2d(origin_x + mean_u, origin_y + mean_v);
+	segment.line_direction = cv::Point2d(std::cos(angle), std::sin(angle));
+
+	// Algebraic circle from the same sums as Algebraic_Fit
+	double circle_rms = std::numeric_limits<double>::infinity();
+	segment.center.x = 0.0;
+	segment.center.y = 0.0;
+	segment.radius = 0.0;
+	double a, b, c;
+	if (Algebraic_Fit::solve_sums(n, s.su, s.sv, s.suu, s.svv, s.suv, s.sz, s.suz, s.svz, a, b, c))
+	{
+		double squared_radius = a * a / 4 + b * b / 4 - c;
+		if (squared_radius > 0.0)
+		{
+			segment.radius = std::sqrt(squared_radius);
+			segment.center.x = origin_x - a / 2;
+			segment.center.y = origin_y - b / 2;
+			double residual_sum = s.szz + a * s.suz + b * s.svz + c * s.sz;
+			circle_rms = std::sqrt(std::max(0.0, residual_sum) / n) / (2 * segment.radius);
+		}
+	}
+
+	if (line_rms <= tolerance || line_rms <= circle_rms)
+	{
+		segment.kind = segment_line;
+		segment.rms = line_rms;
+		segment.center.x = 0.0;
+		segment.center.y = 0.0;
+		segment.radius = 0.0;
+	}
+	else
+	{
+		segment.kind = segment_arc;
+		segment.rms = circle_rms;
+	}
+	return segment;
+}
+
+/**
+* Computes the largest distance of the segment's points to its arc or line
+*
+* @param segment Fitted segment
+*/
+void Arc_Segmenter::compute_max_deviation(Arc_Segment& segment) const {
+	double deviation = 0.0;
+	if (segment.kind == segment_arc)
+	{
+		for (size_t i = segment.first; i <= segment.last; ++i) {
+			double distance = std::sqrt((xs[i] - segment.center.x) * (xs[i] - segment.center.x) + (ys[i] - segment.center.y) * (ys[i] - segment.center.y));
+			deviation = std::max(deviation, std::abs(distance - segment.radius));
+		}
+	}
+	else
+	{
+		for (size_t i = segment.first; i <= segment.last; ++i) {
+			double offset = (xs[i] - segment.line_point.x) * segment.line_direction.y - (ys[i] - segment.line_point.y) * segment.line_direction.x;
+			deviation = std::max(deviation, std::abs(offset));
+		}
+	}
+	segment.max_deviation = deviation;
+}
+
+/**
+* Checks whether the first points of a segment fit an arc or a line within the tolerance
+*
+* @param first Index of the first point of the segment
+* @param point_count Number of points of the segment
+* @param check_deviation Also check the largest distance of a point, which takes a sweep of the points
+* @return true if the points fit
+*/
+bool Arc_Segmenter::is_within_tolerance(size_t first, size_t point_count, bool check_deviation) {
+	Arc_Segment segment = fit_segment(first, point_count);
+	if (segment.rms > tolerance)
+		return false;
+	if (!check_deviation || max_deviation <= 0.0)
+		return true;
+	++check_count;
+	compute_max_deviation(segment);
+	return segment.max_deviation <= max_deviation;
+}
+
+/**
+* Splits the contour into segments from its first point to its last. Each segment starts with
+* min_points points. Its length is doubled until the fit fails, and the end is then bisected between
+* the last length that fitted and the first that did not, each step an O(1) fit from the prefix sums.
+* Only the resulting segment gets a sweep to check its largest deviation. Where even min_points points
+* do not fit, the segment keeps them and its within_tolerance is false
+*
+* @return segments Segments in the order of the contour, together they hold every point once
+*/
+std::vector<Arc_Segment> Arc_Segmenter::compute_segments() {
+	std::vector<Arc_Segment> segments;
+	fit_count = 0;
+	check_count = 0;
+	size_t count = xs.size();
+	size_t first = 0;
+	while (first < count) {
+		size_t remaining = count - first;
+		size_t shortest = std::min(min_points, remaining);
+		size_t good = shortest;
+		prefix_sums.clear();
+		if (is_within_tolerance(first, good, false))
+		{
+			size_t bad = 0;
+			while (good < remaining) {
+				size_t probe = std::min(2 * good, remaining);
+				if (!is_within_tolerance(first, probe, false))
+				{
+					bad = probe;
+					break;
+				}
+				good = probe;
+			}
+			if (bad > 0)
+			{
+				while (bad - good > 1) {
+					size_t middle = good + (bad - good) / 2;
+					if (is_within_tolerance(first, middle, false))
+						good = middle;
+					else
+						bad = middle;
+				}
+			}
+			// A few points far off the fit, such as a short line between two long arcs, barely move the RMS,
+			// so the end is bisected again with the largest deviation checked if the segment fails it
+			if (!is_within_tolerance(first, good, true))
+			{
+				bad = good;
+				good = shortest;
+				if (is_within_tolerance(first, good, true))
+				{
+					while (bad - good > 1) {
+						size_t middle = good + (bad - good) / 2;
+						if (is_within_tolerance(first, middle, true))
+							good = middle;
+						else
+							bad = middle;
+					}
+				}
+			}
+		}
+		// A tail too short to start a segment of its own joins this one if they fit together
+		if (good < remaining && remaining - good < min_points && is_within_tolerance(first, remaining, true))
+			good = remaining;
+
+		Arc_Segment segment = fit_segment(first, good);
+		compute_max_deviation(segment);
+		segment.within_tolerance = segment.rms <= tolerance && (max_deviation <= 0.0 || segment.max_deviation <= max_deviation);
+		segments.push_back(segment);
+		first += good;
+	}
+	return segments;
+}
+
+/**
+* returns the number of O(1) fits from the prefix sums of the last segmentation
+*
+* @return fit_count Number of fits
+*/
+size_t Arc_Segmenter::get_fit_count() {
+	return fit_count;
+}
+
+/**
+* returns the number of sweeps that checked the largest deviation of a segment in the last
+* segmentation
+*
+* @return check_count Number of sweeps
+*/
+size_t Arc_Segmenter::get_check_count() {
+	return check_count;
+}
@@ -0,0 +1,74 @@
+/*
+* @file Arc_Segmenter.h
+* @brief Header file for Arc_Segmenter which splits an ordered contour, a polyline made of circular
+* arcs joined to straight lines, into maximal segments that each fit an arc or a line within a
+* tolerance. Best_Fitting_Circle fits one circle to an unordered set, this walks the points in order.
+*
+* Each segment is grown from its first point while prefix sums of the algebraic fit statistics are
+* kept, so the arc and line fits of the segment ending at any point already summed take O(1). The
+* end is found by doubling the length until the fit fails and then bisecting, so the whole contour
+* takes time close to linear in the number of points.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include <vector>
+
+#pragma once
+#ifndef ARC_SEGMENTER
+#define ARC_SEGMENTER
+
+enum Segment_Kind {
+	segment_line,
+	segment_arc
+};
+
+struct Arc_Segment {
+	size_t first; // Index of the first point
+	size_t last; // Index of the last point
+	Segment_Kind kind;
+	Circle_Center center; // Center of an arc
+	double radius; // Radius of an arc
+	cv::Point2d line_point; // Centroid of a line's points
+	cv::Point2d line_direction; // Unit direction of a line
+	double rms; // RMS distance of the points to the arc or line
+	double max_deviation; // Largest distance of a point to the arc or line
+	bool within_tolerance; // false if the segment fails the tolerance, where even the minimum number of points does not fit
+};
+
+/*
+* Sums of the algebraic fit of the first points of a segment, taken relative to its first point
+*/
+struct Arc_Sums {
+	double su = 0, sv = 0, suu = 0, svv = 0, suv = 0, sz = 0, suz = 0, svz = 0, szz = 0;
+};
+
+class Arc_Segmenter
+{
+private:
+	// Point buffer in structure of arrays layout
+	std::vector<double> xs;
+	std::vector<double> ys;
+
+	double tolerance;
+	double max_deviation;
+	size_t min_points;
+	std::vector<Arc_Sums> prefix_sums; // prefix_sums[k] holds the first k points of the current segment
+	size_t fit_count;
+	size_t check_count;
+
+	void extend_prefix_sums(size_t first, size_t point_count);
+	Arc_Segment fit_segment(size_t first, size_t point_count);
+	void compute_max_deviation(Arc_Segment&) const;
+	bool is_within_tolerance(size_t first, size_t point_count, bool check_deviation);
+public:
+
+	Arc_Segmenter(const std::vector<cv::Point>&);
+	Arc_Segmenter(const std::vector<cv::Point2d>&);
+	void set_tolerance(double tolerance, double max_deviation);
+	void set_min_points(size_t);
+	std::vector<Arc_Segment> compute_segments();
+	size_t get_fit_count();
+	size_t get_check_count();
+};
+#endif
@@ -0,0 +1,219 @@
+/*
+* @file Batch_Fitter.cpp
+* @brief Source file for Batch_Fitter which fits best fit circles to many independent point sets
+* by spreading the sets over a pool of worker threads. Every set of 2D points is fitted by
+* fit_best_circle, sets of 3D points with best fit spheres.
+*
+*/
+#include "Batch_Fitter.h"
+
+/**
+* Constructor to setup the number of worker threads
+*
+* @param thread_count Number of worker threads, 0 uses every available core
+*
+*/
+Batch_Fitter::Batch_Fitter(unsigned int thread_count) {
+	if (thread_count == 0)
+		thread_count = std::thread::hardware_concurrency();
+	this->thread_count = (thread_count > 0) ? thread_count : 1;
+	this->next_job = 0;
+}
+
+/**
+* Destructor to stop and join the worker threads
+*
+*/
+Batch_Fitter::~Batch_Fitter() {
+	{
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		is_stopping = true;
+	}
+	job_ready.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+/**
+* Fits a single set of 3D points. Sets with less than four points cannot form a sphere
+*
+* @param points Points of one set
+* @return result Center, radius and state of the fit
+*
+*/
+Sphere_Result Batch_Fitter::fit_one_sphere(const std::vector<cv::Point3d>& points) {
+	Sphere_Result result;
+	result.center.x = 0.0;
+	result.center.y = 0.0;
+	result.center.z = 0.0;
+	result.radius = 0.0;
+	result.is_computable = false;
+	if (points.size() < 4)
+		return result;
+
+	Hypersphere_Fitter<3, Point_View<3, cv::Point3d>> best_fit_sphere(points);
+	result.is_computable = best_fit_sphere.compute_best_fit_sphere();
+	if (result.is_computable)
+	{
+		Hypersphere_Fitter<3, Point_View<3, cv::Point3d>>::Vector center = best_fit_sphere.get_center();
+		result.center.x = center[0];
+		result.center.y = center[1];
+		result.center.z = center[2];
+		result.radius = best_fit_sphere.get_radius();
+	}
+	return result;
+}
+
+/**
+* Loop of a worker thread: waits for the next batch, pulls jobs from it until none are left and
+* reports back, until the Batch_Fitter is destroyed
+*
+*/
+void Batch_Fitter::work() {
+	unsigned long long seen_generation = 0;
+	while (true) {
+		const std::function<void(size_t)>* current_job;
+		size_t count;
+		{
+			std::unique_lock<std::mutex> lock(pool_mutex);
+			job_ready.wait(lock, [&] { return is_stopping || job_generation != seen_generation; });
+			if (is_stopping)
+				return;
+			seen_generation = job_generation;
+			current_job = job;
+			count = job_count;
+		}
+		for (size_t i = next_job++; i < count; i = next_job++) {
+			(*current_job)(i);
+		}
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		if (--busy_workers == 0)
+			job_done.notify_one();
+	}
+}
+
+/**
+* Runs job(i) for every i below count on the worker pool. Worker threads pull the next index
+* from a shared counter so that jobs of uneven size are balanced between the threads.
+*
+* @param count Number of jobs
+* @param job Job to run for each index
+*
+*/
+void Batch_Fitter::run_workers(size_t count, const std::function<void(size_t)>& job) {
+	if (thread_count == 1 || count < 2)
+	{
+		// Not worth waking the workers
+		for (size_t i = 0; i < count; ++i) {
+			job(i);
+		}
+		return;
+	}
+	if (workers.empty())
+	{
+		for (unsigned int t = 1; t < thread_count; ++t) {
+			workers.emplace_back(&Batch_Fitter::work, this);
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		this->job = &job;
+		job_count = count;
+		next_job = 0;
+		busy_workers = (unsigned int)workers.size();
+		++job_generation;
+	}
+	job_ready.notify_all();
+	for (size_t i = next_job++; i < count; i = next_job++) {
+		job(i); // Calling thread takes a share of the work
+	}
+	std::unique_lock<std::mutex> lock(pool_mutex);
+	job_done.wait(lock, [this] { return busy_workers == 0; });
+}
+
+/**
+* Fits every point set in the batch. Worker threads pull the next unfitted set from a shared
+* counter so that sets of uneven size are balanced between the threads.
+*
+* When a cache is given, point sets that repeat within the batch are fitted only once and sets
+* whose result is already cached are not fitted at all
+*
+* @param point_sets List of point sets to fit
+* @param cache Optional cache of previous fit results
+* @return results Fit result for each point set in the same order as the input
+*
+*/
+std::vector<Fit_Result> Batch_Fitter::fit(const std::vector<std::vector<cv::Point>>& point_sets, Fit_Cache* cache) {
+	std::vector<Fit_Result> results(point_sets.size());
+
+	// Indices of the sets that have to be fitted and, for each input set, the set whose result it shares
+	std::vector<size_t> to_fit;
+	std::vector<size_t> source(point_sets.size());
+	std::vector<Point_Set_Hash> keys;
+	if (cache == nullptr)
+	{
+		to_fit.resize(point_sets.size());
+		for (size_t i = 0; i < point_sets.size(); ++i) {
+			to_fit[i] = i;
+			source[i] = i;
+		}
+	}
+	else
+	{
+		keys.resize(point_sets.size());
+		std::unordered_map<uint64_t, size_t> first_seen;
+		for (size_t i = 0; i < point_sets.size(); ++i) {
+			keys[i] = Point_Set_Hash::of(point_sets[i]);
+			source[i] = i;
+			auto found = first_seen.find(keys[i].get_hash());
+			if (found != first_seen.end() && keys[found->second] == keys[i])
+				source[i] = found->second; // Repeat of an earlier set in this batch
+			else if (!cache->lookup(keys[i], results[i]))
+			{
+				first_seen[keys[i].get_hash()] = i;
+				to_fit.push_back(i);
+			}
+		}
+	}
+
+	run_workers(to_fit.size(), [&](size_t i) {
+		results[to_fit[i]] = fit_best_circle(point_sets[to_fit[i]]);
+	});
+
+	if (cache != nullptr)
+	{
+		for (auto i : to_fit) {
+			cache->insert(keys[i], results[i]);
+		}
+		for (size_t i = 0; i < point_sets.size(); ++i) {
+			if (source[i] != i)
+				results[i] = results[source[i]];
+		}
+	}
+	return results;
+}
+
+/**
+* Fits a best fit sphere to every set of 3D points in the batch
+*
+* @param point_sets List of 3D point sets to fit
+* @return results Fit result for each point set in the same order as the input
+*
+*/
+std::vector<Sphere_Result> Batch_Fitter::fit_spheres(const std::vector<std::vector<cv::Point3d>>& point_sets) {
+	std::vector<Sphere_Result> results(point_sets.size());
+	run_workers(point_sets.size(), [&](size_t i) {
+		results[i] = fit_one_sphere(point_sets[i]);
+	});
+	return results;
+}
+
+/**
+* returns the number of worker threads
+*
+* @return thread_count Number of worker threads
+*/
+unsigned int Batch_Fitter::get_thread_count() {
+	return thread_count;
+}
@@ -0,0 +1,56 @@
+/*
+* @file Batch_Fitter.h
+* @brief Header file for Batch_Fitter which fits best fit circles to many independent point sets
+* by spreading the sets over a pool of worker threads. Every set of 2D points is fitted by
+* fit_best_circle, sets of 3D points with best fit spheres.
+*
+* The worker threads are started by the first batch that needs them and sleep between batches until
+* the Batch_Fitter is destroyed. A Batch_Fitter fits one batch at a time.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include "Fit_Cache.h"
+#include "Hypersphere_Fitter.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#pragma once
+#ifndef BATCH_FITTER
+#define BATCH_FITTER
+
+class Batch_Fitter
+{
+private:
+	unsigned int thread_count;
+
+	// Worker pool, the calling thread of a batch works alongside thread_count - 1 workers
+	std::vector<std::thread> workers;
+	std::mutex pool_mutex;
+	std::condition_variable job_ready;
+	std::condition_variable job_done;
+	const std::function<void(size_t)>* job = nullptr;
+	size_t job_count = 0;
+	std::atomic<size_t> next_job;
+	unsigned long long job_generation = 0; // Incremented for every batch handed to the workers
+	unsigned int busy_workers = 0;
+	bool is_stopping = false;
+
+	Sphere_Result fit_one_sphere(const std::vector<cv::Point3d>&);
+	void run_workers(size_t, const std::function<void(size_t)>&);
+	void work();
+public:
+
+	Batch_Fitter(unsigned int thread_count = 0);
+	~Batch_Fitter();
+	Batch_Fitter(const Batch_Fitter&) = delete;
+	Batch_Fitter& operator=(const Batch_Fitter&) = delete;
+	std::vector<Fit_Result> fit(const std::vector<std::vector<cv::Point>>&, Fit_Cache* cache = nullptr);
+	std::vector<Sphere_Result> fit_spheres(const std::vector<std::vector<cv::Point3d>>&);
+	unsigned int get_thread_count();
+};
+#endif
@@ -0,0 +1,82 @@
+/*
+* @file Best_Fit_C_API.cpp
+* @brief Implements the C interface to the core library on top of Batch_Fitter. Exceptions are
+* caught here and returned as status codes.
+*
+*/
+#include "Best_Fit_C_API.h"
+#include "Batch_Fitter.h"
+#include <new>
+
+/**
+* Copies a fit result into the C result structure
+*
+* @param fit_result Fit result
+* @param result C result
+*/
+static void copy_result(const Fit_Result& fit_result, best_fit_circle* result) {
+	result->center_x = fit_result.is_computable ? fit_result.center.x : 0.0;
+	result->center_y = fit_result.is_computable ? fit_result.center.y : 0.0;
+	result->radius = fit_result.is_computable ? fit_result.radius : 0.0;
+	result->is_computable = fit_result.is_computable ? 1 : 0;
+}
+
+/**
+* Fits one circle
+*
+* @param coordinates Points stored as x, y pairs
+* @param point_count Number of points
+* @param result Fitted circle
+* @return status BEST_FIT_OK or an error code
+*/
+int best_fit_circle_fit(const int32_t* coordinates, size_t point_count, best_fit_circle* result) {
+	size_t set_end = point_count;
+	return best_fit_circle_fit_batch(coordinates, &set_end, 1, 1, result);
+}
+
+/**
+* Fits a circle to each point set of a batch on the worker threads
+*
+* @param coordinates Points of all the sets stored as x, y pairs
+* @param set_ends End of each set, in points
+* @param set_count Number of sets
+* @param thread_count Number of worker threads, 0 uses every available core
+* @param results Fitted circle of each set
+* @return status BEST_FIT_OK or an error code
+*/
+int best_fit_circle_fit_batch(const int32_t* coordinates, const size_t* set_ends, size_t set_count,
+	unsigned int thread_count, best_fit_circle* results) {
+	if (set_count == 0)
+		return BEST_FIT_OK;
+	if (set_ends == nullptr || results == nullptr || (coordinates == nullptr && set_ends[set_count - 1] > 0))
+		return BEST_FIT_INVALID_ARGUMENT;
+	try
+	{
+		std::vector<std::vector<cv::Point>> point_sets(set_count);
+		size_t set_start = 0;
+		for (size_t s = 0; s < set_count; ++s) {
+			if (set_ends[s] < set_start)
+				return BEST_FIT_INVALID_ARGUMENT; // Set ends have to be ascending
+			point_sets[s].resize(set_ends[s] - set_start);
+			for (size_t p = set_start; p < set_ends[s]; ++p) {
+				point_sets[s][p - set_start] = cv::Point(coordinates[2 * p], coordinates[2 * p + 1]);
+			}
+			set_start = set_ends[s];
+		}
+
+		Batch_Fitter batch_fitter(thread_count);
+		std::vector<Fit_Result> fit_results = batch_fitter.fit(point_sets);
+		for (size_t s = 0; s < set_count; ++s) {
+			copy_result(fit_results[s], &results[s]);
+		}
+		return BEST_FIT_OK;
+	}
+	catch (const std::bad_alloc&)
+	{
+		return BEST_FIT_OUT_OF_MEMORY;
+	}
+	catch (...)
+	{
+		return BEST_FIT_INTERNAL_ERROR;
+	}
+}
@@ -0,0 +1,61 @@
+/*
+* @file Best_Fit_C_API.h
+* @brief C interface to the core library for services written in other languages. Point sets are
+* passed as int32 (x, y) pairs, the same layout as the Fitting Daemon protocol, and are fitted in
+* parallel by Batch_Fitter. No C++ type or exception crosses the interface.
+*
+*/
+
+#pragma once
+#ifndef BEST_FIT_C_API
+#define BEST_FIT_C_API
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(BEST_FIT_CIRCLES_SHARED)
+#ifdef BEST_FIT_CIRCLES_EXPORTS
+#define BEST_FIT_API __declspec(dllexport)
+#else
+#define BEST_FIT_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define BEST_FIT_API __attribute__((visibility("default")))
+#else
+#define BEST_FIT_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Status codes returned by the functions below */
+#define BEST_FIT_OK 0
+#define BEST_FIT_INVALID_ARGUMENT -1
+#define BEST_FIT_OUT_OF_MEMORY -2
+#define BEST_FIT_INTERNAL_ERROR -3
+
+typedef struct best_fit_circle {
+	double center_x;
+	double center_y;
+	double radius;
+	int is_computable; /* 0 if the points cannot form a circle */
+} best_fit_circle;
+
+/*
+* Fits one circle to point_count points stored as x0, y0, x1, y1, ...
+*/
+BEST_FIT_API int best_fit_circle_fit(const int32_t* coordinates, size_t point_count, best_fit_circle* result);
+
+/*
+* Fits a circle to each of set_count point sets. The points of all the sets are stored one set
+* after the other in coordinates as x, y pairs, and set i holds points set_ends[i - 1] to
+* set_ends[i] - 1, starting from 0. thread_count 0 uses every available core.
+*/
+BEST_FIT_API int best_fit_circle_fit_batch(const int32_t* coordinates, const size_t* set_ends, size_t set_count,
+	unsigned int thread_count, best_fit_circle* results);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
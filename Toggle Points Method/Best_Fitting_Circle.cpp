@@ -15,6 +15,9 @@
 
 */
 #include "Best_Fitting_Circle.h"
+#include "Anytime_Fit.h"
+#include "Fixed_Size_Fitter.h"
+#include "Hypersphere_Fitter.h"
 
 /**
 * Constructor to setup points and initialize circle center and radius
@@ -23,11 +26,13 @@
 *
 *
 */
-Best_Fitting_Circle::Best_Fitting_Circle(std::vector<cv::Point> selected_points) {
+Best_Fitting_Circle::Best_Fitting_Circle(const std::vector<cv::Point>& selected_points) {
 	this->selected_points = selected_points;
 	this->circle_center_est.x = 0.0;
 	this->circle_center_est.y = 0.0;
 	this->radius_estimate = 0.0;
+	this->cost = 0.0;
+	this->iteration_count = 0;
 }
 
 /**
@@ -67,7 +72,7 @@ Circle_Center Best_Fitting_Circle::calculate_circumcenter(cv::Point point_i, cv:
 *
 */
 
-Circle_Center Best_Fitting_Circle::initial_estimate(std::vector<cv::Point> points) {
+Circle_Center Best_Fitting_Circle::initial_estimate(const std::vector<cv::Point>& points) {
 	double sigma_x = 0;
 	double sigma_y = 0;
 	int q = 0;
@@ -85,13 +90,10 @@ Circle_Center Best_Fitting_Circle::initial_estimate(std::vector<cv::Point> point
 				jk = cv::Point(points[k].x - points[j].x, points[k].y - points[j].y);
 				ki = cv::Point(points[i].x - points[k].x, points[i].y - points[k].y);
 				delta = (jk.x * ij.y) - (ij.x * jk.y);
-				if (abs(delta) < 1.0e-10)
+				if (std::abs(delta) < 1.0e-10)
 				{
-					// Circle cannot be computed because all the points are alligned in the same axis
-					center_increment.x = -1.0;
-					center_increment.y = -1.0;
-					std::cout << "Invalid point selection. Please reset and select new points" << std::endl;
-					return circle_center_est;
+					// Aligned triplets have no circumcenter and are left out of the average
+					continue;
 				}
 				else {
 					// Get an estimate for the circle's center by summing all the possible circumcenters
@@ -103,6 +105,15 @@ Circle_Center Best_Fitting_Circle::initial_estimate(std::vector<cv::Point> point
 			}
 		}
 	}
+	if (q == 0)
+	{
+		// Circle cannot be computed because all the points are alligned in the same axis
+		if (verbose)
+			std::cout << "Invalid point selection. Please reset and select new points" << std::endl;
+		circle_center_est.x = -1.0;
+		circle_center_est.y = -1.0;
+		return circle_center_est;
+	}
 	// Divide the center by the count to get an average value
 	circle_center_est.x /= q;
 	circle_center_est.y /= q;
@@ -110,198 +121,154 @@ Circle_Center Best_Fitting_Circle::initial_estimate(std::vector<cv::Point> point
 }
 
 /**
-* Determine the best radius estimate when given a set of points
+* Check to see if a best fit circle can be computed using the POLAK and RIBI`ERE reducing method.
+* Small sets are dispatched to Fixed_Size_Fitter, but only after the constructor has copied them,
+* callers fitting many small sets should use fit_best_circle instead
 *
-* @param points Points list selected by the user
-* @return radius_estimate Estimation of the radius
+* @return true if a best fit circle is cimputable or else return false
 *
 */
-double Best_Fitting_Circle::compute_radius_estimate(std::vector<cv::Point> points) {
-	for (auto point : points) {
-		// Sum the distance to all the possible points
-		radius_estimate += get_distance(point.x, circle_center_est.x, point.y, circle_center_est.y);
+bool Best_Fitting_Circle::compute_best_fit_circle() {
+	if (selected_points.size() >= 3 && selected_points.size() <= max_fixed_size_points)
+		return compute_fixed_size_fit();
+	Circle_Center circle_center_estimate;
+	circle_center_estimate = initial_estimate(selected_points); //Calculate intial estimate for center coordinates
+	if (circle_center_estimate.x > -1 && circle_center_estimate.y > -1) { //Center can be computed
+		return refine_best_fit_circle(circle_center_estimate);
 	}
-	// Divide by number of points 
-	radius_estimate /= points.size();
-	return radius_estimate;
-}
-
-/**
- * Calculates the distance between two coordinates
- *
- *
- * @param x1 First coordinate's x value
- * @param x2 Second coordinate's x value
- * @param y1 First coordinate's x value
- * @param y2 Second coordinate's x value
- * @return distance between the coordinate points
- *
- */
-double Best_Fitting_Circle::get_distance(const int x1, const int x2, const int y1, const int y2) {
-	return sqrt(pow(y2 - y1, 2) + pow(x2 - x1, 2));
+	return false;
 }
 
 /**
-* Determine the cost given the updated radius and distances to be used in
-* gradient computation
+* Fits a small point set with the fitter specialized for its size, see Fixed_Size_Fitter.h
 *
-* @param points Points list selected by the user
-* @return cost Cost value
+* @return true if a best fit circle is computable or else return false
 *
 */
-double Best_Fitting_Circle::cost_function(std::vector<cv::Point> points) {
-	double cost = 0.0;
-	for (auto point : points) {
-		// Summation of cost value
-		cost += pow(get_distance(point.x, circle_center_est.x, point.y, circle_center_est.y) - radius_estimate, 2);
-
+bool Best_Fitting_Circle::compute_fixed_size_fit() {
+	Fit_Result result;
+	fit_fixed_size(selected_points.data(), selected_points.size(), result, cost, iteration_count, step_tolerance);
+	circle_center_est = result.center;
+	radius_estimate = result.radius;
+	if (!result.is_computable)
+	{
+		if (verbose)
+			std::cout << "Invalid point selection. Please reset and select new points" << std::endl;
+		return false;
 	}
-	return cost;
+	if (verbose)
+	{
+		std::cout << "radius estimate = " << radius_estimate << std::endl;
+		std::cout << "circle center = " << circle_center_est.x << " , " << circle_center_est.y << std::endl;
+	}
+	return true;
 }
 
 /**
-* Determine the gradients for each coordinate to use to determine conjugate gradient
+* Refines a given estimate of the circle's center with the POLAK and RIBI`ERE reducing method
+* without running the point triplet initializer. Used when a good estimate is already known,
+* for example the circle fitted to the previous frame of a sequence
 *
-* @param points Points list selected by the user
-* @return cost_gradient Cost gradient for each coordinate
+* @param center_estimate Starting estimate of the circle's center
+* @return true if a best fit circle is computable or else return false
 *
 */
-Gradient Best_Fitting_Circle::get_gradient_for_conjugate_gradient(std::vector<cv::Point> points) {
-	Gradient cost_gradient;
-	cost_gradient.x = 0.0;
-	cost_gradient.y = 0.0;
-	/*Iterate throught the points and determine the cost gradient to the
-	   respective circle center estimate and  distance from circle center to each point
-	*/
-	for (auto point : points) {
-		cost_gradient.x += (circle_center_est.x - point.x) * (get_distance(point.x, circle_center_est.x,
-			point.y, circle_center_est.y) - radius_estimate);
-		cost_gradient.y += (circle_center_est.y - point.y) * (get_distance(point.x, circle_center_est.x,
-			point.y, circle_center_est.y) - radius_estimate);
+bool Best_Fitting_Circle::refine_best_fit_circle(Circle_Center center_estimate) {
+	// The radius estimate, cost, gradient and POLAK and RIBI`ERE iterations run in the shared engine, on the points in place
+	Hypersphere_Fitter<2, Point_View<2, cv::Point>> engine(selected_points);
+	engine.set_step_tolerance(step_tolerance);
+	bool convergence = engine.refine_best_fit_sphere({ center_estimate.x, center_estimate.y }); //State of convergence
+	circle_center_est.x = engine.get_center()[0];
+	circle_center_est.y = engine.get_center()[1];
+	radius_estimate = engine.get_radius();
+	cost = engine.get_cost();
+	iteration_count += engine.get_iteration_count();
+	if (!convergence)
+	{
+		// Circle cannot be formed
+		if (verbose)
+			std::cout << "Cannot Compute circle with given points. Please reset and enter new points";
+		return false;
+	}
+	if (verbose)
+	{
+		// Print out circle's estimates of radius and center coordinates
+		std::cout << "radius estimate = " << radius_estimate << std::endl;
+		std::cout << "circle center = " << circle_center_est.x << " , " << circle_center_est.y << std::endl;
 	}
-	// Multiply the cost gradient by 2 as given per equation
-	cost_gradient.x *= 2;
-	cost_gradient.y *= 2;
-	return cost_gradient;
+	return true;
 }
 
 /**
-* Computes the lambda value by performing the Newton solver on the derivative
-* of the cost function.
+* Fits the circle within a time budget, an iteration budget and a target RMS residual, for callers
+* with a hard latency limit. The center starts from a single sweep algebraic fit instead of the
+* point triplet initializer, whose time grows with the cube of the number of points. The reducing
+* method stops as soon as any limit is reached and returns the best circle found so far
 *
-* @param points Points list selected by the user
-* @param u Directional gradient
-* @return lambda updated lambda value
+* @param budget Limits of the fit
+* @return result Best circle, whether it converged, why it stopped, its RMS residual and steps
 *
 */
-double Best_Fitting_Circle::compute_lambda(std::vector<cv::Point> points, Gradient u) {
-	double sum1 = 0, sum2 = 0, sum_fac = 0, sum_fac_dr = 0;
-	// Iterate through the points and find the different sum parameters
-	for (auto point : points) {
-		double dx = circle_center_est.x - point.x;
-		double dy = circle_center_est.y - point.y;
-		double dxdy = sqrt(pow(dx, 2) + pow(dy, 2));
-		double c1 = (dx * u.x + dy * u.y) / dxdy;
-		double c2 = dxdy - radius_estimate;
-		sum1 += c1 * c2;
-		sum2 += c2 / dxdy;
-		sum_fac += c1;
-		sum_fac_dr += c1 * c1 / dxdy;
-
-
+Anytime_Result Best_Fitting_Circle::compute_anytime_fit(const Fit_Budget& budget) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Hypersphere_Fitter<2, Point_View<2, cv::Point>> engine(selected_points);
+	Anytime_Result result = run_anytime_fit(engine, budget, start, step_tolerance);
+	iteration_count += result.iteration_count;
+	if (!result.fit.is_computable)
+	{
+		if (verbose)
+			std::cout << "Invalid point selection. Please reset and select new points" << std::endl;
+		return result;
+	}
+	circle_center_est = result.fit.center;
+	radius_estimate = result.fit.radius;
+	cost = engine.get_cost();
+	if (verbose)
+	{
+		std::cout << "radius estimate = " << radius_estimate << std::endl;
+		std::cout << "circle center = " << circle_center_est.x << " , " << circle_center_est.y << std::endl;
 	}
-	// Compute lambda value using Newton step method
-	double lambda = (-1 * sum1);
-	lambda /= ((pow(u.x, 2) + pow(u.y, 2))
-		* sum2 - sum_fac * sum_fac / points.size()
-		+ radius_estimate * sum_fac_dr);
-	return lambda;
+	return result;
 }
 
 /**
-* Computes the conjugate gradient by using POLAK and RIBI`ERE method to
-* determine if the algorithm can converge within a set of iterations to find
-* the best possible circle fit
+* Fits a point set without building a Best_Fitting_Circle, whose constructor copies the points.
+* Sets with less than three points cannot form a circle. Sets of up to max_fixed_size_points points
+* are fitted on the stack by Fixed_Size_Fitter. Larger sets are refined on the points in place from
+* the single sweep algebraic center instead of the point triplet initializer, whose time grows with
+* the cube of the number of points
 *
-* @param Gradient cost_gradient cost gradient calculated in get_gradient_for_converge()
-* @return the state of convergence
+* @param points Points of one set
+* @return result Center, radius and state of the fit
 *
 */
-bool Best_Fitting_Circle::converge(Gradient cost_gradient) {
-	if (cost < 1.0e-10 || sqrt(pow(cost_gradient.x, 2) + pow(cost_gradient.y, 2)) < 1.0e-10) {
-		return true; //found out minimum solution
+Fit_Result fit_best_circle(const std::vector<cv::Point>& points) {
+	Fit_Result result;
+	result.center.x = 0.0;
+	result.center.y = 0.0;
+	result.radius = 0.0;
+	result.is_computable = false;
+	if (points.size() < 3)
+		return result;
+	if (points.size() <= max_fixed_size_points)
+	{
+		double cost;
+		int iteration_count;
+		fit_fixed_size(points.data(), points.size(), result, cost, iteration_count);
+		return result;
 	}
-	else {
-		double previous_cost = cost;
-		Gradient previouos_cost_gradient = cost_gradient;
-		Gradient u_prev;
-		u_prev.x = 0;
-		u_prev.y = 0;
-		// Loop through set number of iterations to find convergence
-		for (int i = 0; i < 100; i++) {
-			// Directional gradient
-			Gradient u;
-			u.x = -1 * cost_gradient.x;
-			u.y = -1 * cost_gradient.y;
 
-			if (i > 0) {
-				//Compute new directional gradient values
-				double beta = (cost_gradient.x * (cost_gradient.x - previouos_cost_gradient.x) + cost_gradient.y * (cost_gradient.y - previouos_cost_gradient.y));
-				beta /= (previouos_cost_gradient.x * previouos_cost_gradient.x + previouos_cost_gradient.y + previouos_cost_gradient.y);
-				u.x += beta * u_prev.x;
-				u.y += beta * u_prev.y;
-			}
-			// Store the current values for future use
-			previouos_cost_gradient.x = cost_gradient.x;
-			previouos_cost_gradient.y = cost_gradient.y;
-			u_prev.x = u.x;
-			u_prev.y = u.y;
-			double previous_cost;
-
-			do {
-				// Reducing the circle parameters until convergence is found
-				previous_cost = cost;
-				double lambda = compute_lambda(selected_points, u);
-				circle_center_est.x += lambda * u.x;
-				circle_center_est.y += lambda * u.y;
-				radius_estimate = compute_radius_estimate(selected_points);
-				cost = cost_function(selected_points);
-			} while (++i < 10 && (abs(cost - previous_cost)) / (cost > 0.1));
-			if ((abs(cost - previous_cost)) / cost < 1.0e-12)
-			{ // If convergence is found, return true
-				return true;
-			}
-			previous_cost = cost;
-		}
+	Hypersphere_Fitter<2, Point_View<2, cv::Point>> engine(points);
+	if (!engine.initial_estimate())
+		return result;
+	result.is_computable = engine.refine_best_fit_sphere(engine.get_center());
+	if (result.is_computable)
+	{
+		result.center.x = engine.get_center()[0];
+		result.center.y = engine.get_center()[1];
+		result.radius = engine.get_radius();
 	}
-	return false;
-}
-/**
-* Check to see if a best fit circle can be computed using the POLAK and RIBI`ERE reducing method
-*
-* @return true if a best fit circle is cimputable or else return false
-*
-*/
-bool Best_Fitting_Circle::compute_best_fit_circle() {
-	Circle_Center circle_center_estimate;
-	circle_center_estimate = initial_estimate(selected_points); //Calculate intial estimate for center coordinates
-	if (circle_center_estimate.x > -1 && circle_center_estimate.y > -1) { //Center can be computed
-		compute_radius_estimate(selected_points); //Calculate intial radius
-		cost = cost_function(selected_points); //Calculate cost 
-		Gradient cost_gradient = get_gradient_for_conjugate_gradient(selected_points); //Calculate cost gradients
-		bool convergence = converge(cost_gradient); //State of convergence
-		if (!convergence)
-		{
-			// Circle cannot be formed
-			std::cout << "Cannot Compute circle with given points. Please reset and enter new points";
-			return false;
-		}
-		// Print out circle's estimates of radius and center coordinates
-		std::cout << "radius estimate = " << radius_estimate << std::endl;
-		std::cout << "circle center = " << circle_center_est.x << " , " << circle_center_est.y << std::endl;
-		return true;
-	}
-	return false;
+	return result;
 }
 
 /**
@@ -320,4 +287,43 @@ Circle_Center Best_Fitting_Circle::get_center_coordinate() {
 */
 double Best_Fitting_Circle::get_radius() {
 	return radius_estimate;
+}
+
+/**
+* returns the least squares cost of the current estimate
+*
+* @return cost Sum of squared distances between the points and the circle
+*/
+double Best_Fitting_Circle::get_cost() {
+	return cost;
+}
+
+/**
+* returns the number of line search steps taken by the reducing method
+*
+* @return iteration_count Number of steps
+*/
+int Best_Fitting_Circle::get_iteration_count() {
+	return iteration_count;
+}
+
+/**
+* Sets a tolerance on the center's movement. The reducing method stops once a whole line search
+* moves the center less than the tolerance, instead of waiting for the cost to stop decreasing.
+* Used when the result only has to be accurate to a known distance
+*
+* @param step_tolerance Distance in the units of the points, 0 to disable
+*/
+void Best_Fitting_Circle::set_step_tolerance(double step_tolerance) {
+	this->step_tolerance = step_tolerance;
+}
+
+/**
+* Enables or disables the diagnostic messages printed to the terminal. Batch callers fitting
+* many point sets from several threads turn this off.
+*
+* @param verbose true to print fit results and errors
+*/
+void Best_Fitting_Circle::set_verbose(bool verbose) {
+	this->verbose = verbose;
 }
\ No newline at end of file
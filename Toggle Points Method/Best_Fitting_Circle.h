@@ -15,7 +15,9 @@
 
 */
 
-#include <opencv2/opencv.hpp>
+#include <opencv2/core.hpp>
+#include "Fit_Budget.h"
+#include "Geometry.h"
 #include <vector>
 
 #pragma once
@@ -30,6 +32,18 @@ struct Circle_Center {
 	double x;
 	double y;
 };
+struct Fit_Result {
+	Circle_Center center;
+	double radius;
+	bool is_computable;
+};
+struct Anytime_Result {
+	Fit_Result fit; // Best circle found within the budget, is_computable is false if no circle can be formed or the fit failed
+	bool converged; // Converged or reached the target RMS residual
+	Fit_Stop stop;
+	double rms;
+	int iteration_count;
+};
 
 class Best_Fitting_Circle
 {
@@ -39,19 +53,26 @@ private:
 	double cost;
 	std::vector<cv::Point> selected_points;
 	double delta;
+	int iteration_count;
+	bool verbose = true;
+	double step_tolerance = 0.0;
+
+	bool compute_fixed_size_fit();
 public:
 
-	Best_Fitting_Circle(std::vector<cv::Point>);
+	Best_Fitting_Circle(const std::vector<cv::Point>&);
 	bool compute_best_fit_circle();
-	bool converge(Gradient);
-	double compute_lambda(std::vector<cv::Point>, Gradient);
-	Gradient get_gradient_for_conjugate_gradient(std::vector<cv::Point>);
-	double cost_function(std::vector<cv::Point>);
-	double compute_radius_estimate(std::vector<cv::Point>);
-	Circle_Center initial_estimate(std::vector<cv::Point> points);
+	bool refine_best_fit_circle(Circle_Center);
+	Anytime_Result compute_anytime_fit(const Fit_Budget&);
+	Circle_Center initial_estimate(const std::vector<cv::Point>& points);
 	Circle_Center calculate_circumcenter(cv::Point, cv::Point, cv::Point, double);
-	double get_distance(const int x1, const int x2, const int y1, const int y2);
 	double get_radius();
 	Circle_Center get_center_coordinate();
+	double get_cost();
+	int get_iteration_count();
+	void set_verbose(bool);
+	void set_step_tolerance(double);
 };
+
+Fit_Result fit_best_circle(const std::vector<cv::Point>&);
 #endif
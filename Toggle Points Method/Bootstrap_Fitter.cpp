@@ -0,0 +1,227 @@
+/*
+* @file Bootstrap_Fitter.cpp
+* @brief Source file for Bootstrap_Fitter which computes percentile bootstrap confidence intervals
+* for the center and radius of a best fit circle.
+*
+*/
+#include "Bootstrap_Fitter.h"
+#include "Algebraic_Fit.h"
+#include "Weighted_Refinement.h"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+// Line search steps allowed for the full data fit and for each warm started resample fit
+const int full_fit_steps = 100;
+const int resample_steps = 30;
+// Slack for the rounding of (1 - confidence) / 2, so that 20 resamples are enough at a confidence of 0.9
+const double tail_rounding = 1.0e-9;
+
+/**
+* Returns the given quantile of sorted values, interpolating between neighbouring values
+*
+* @param sorted Values in increasing order
+* @param q Quantile between 0 and 1
+* @return value Quantile of the values
+*/
+static double get_quantile(const std::vector<double>& sorted, double q) {
+	double position = q * (sorted.size() - 1);
+	size_t below = (size_t)position;
+	if (below + 1 >= sorted.size())
+		return sorted.back();
+	double fraction = position - below;
+	return sorted[below] * (1 - fraction) + sorted[below + 1] * fraction;
+}
+
+/**
+* Constructor to copy the points into the shared structure of arrays buffer
+*
+* @param points Points list selected by the user
+* @param thread_count Number of worker threads, 0 uses every available core
+*
+*/
+Bootstrap_Fitter::Bootstrap_Fitter(const std::vector<cv::Point>& points, unsigned int thread_count) {
+	xs.resize(points.size());
+	ys.resize(points.size());
+	for (size_t i = 0; i < points.size(); ++i) {
+		xs[i] = points[i].x;
+		ys[i] = points[i].y;
+	}
+	if (thread_count == 0)
+		thread_count = std::thread::hardware_concurrency();
+	this->thread_count = (thread_count > 0) ? thread_count : 1;
+	full_fit.center.x = 0.0;
+	full_fit.center.y = 0.0;
+	full_fit.radius = 0.0;
+	full_fit.is_computable = false;
+	center_x_interval = { 0.0, 0.0 };
+	center_y_interval = { 0.0, 0.0 };
+	radius_interval = { 0.0, 0.0 };
+}
+
+/**
+* Refines a circle on the shared points where each point counts as many times as its multiplicity
+*
+* @param multiplicity Number of times each point is counted, nullptr counts every point once
+* @param center Starting center, replaced by the refined center
+* @param radius Replaced by the refined radius
+* @param max_steps Maximum number of line search steps
+* @return true if the fit has a finite center and radius
+*/
+bool Bootstrap_Fitter::fit_weighted(const double* multiplicity, Circle_Center& center, double& radius, int max_steps) {
+	Weighted_Point_View points(xs.data(), ys.data(), multiplicity, xs.size());
+	double cost = 0.0;
+	refine_weighted(points, center, radius, cost, max_steps, 1.0e-9 * std::max(1.0, radius));
+	return std::isfinite(center.x) && std::isfinite(center.y) && std::isfinite(radius);
+}
+
+/**
+* Fits the full data, then fits resample_count resamples drawn with replacement and takes the
+* percentile interval of each of the center coordinates and the radius.
+*
+* Each resample is drawn from its own generator seeded from seed and its index, so the intervals
+* do not depend on the number of threads. Each tail of an interval holds a fraction (1 - confidence) / 2
+* of the resamples, which has to be at least one resample for the percentiles to be defined
+*
+* @param resample_count Number of bootstrap resamples
+* @param confidence Confidence level of the intervals, strictly between 0 and 1, e.g. 0.95
+* @param seed Seed of the resampling
+* @return true if the full data circle could be fitted and enough resamples were fitted for each
+* tail to hold one, false also if confidence is out of range or resample_count too small
+*/
+bool Bootstrap_Fitter::compute_bootstrap(unsigned int resample_count, double confidence, uint64_t seed) {
+	samples.clear();
+	full_fit.is_computable = false;
+	size_t count = xs.size();
+	if (count < 3)
+		return false;
+	if (!(confidence > 0 && confidence < 1))
+		return false;
+	double tail = (1 - confidence) / 2;
+	if (resample_count * tail < 1 - tail_rounding)
+		return false; // Too few resamples for a sample in each tail
+
+	// Full data fit: algebraic estimate refined with the geometric cost
+	Algebraic_Fit algebraic_fit;
+	for (size_t i = 0; i < count; ++i) {
+		algebraic_fit.add(xs[i], ys[i]);
+	}
+	if (!algebraic_fit.solve(full_fit.center, full_fit.radius))
+		return false;
+	full_fit.is_computable = fit_weighted(nullptr, full_fit.center, full_fit.radius, full_fit_steps);
+	if (!full_fit.is_computable)
+		return false;
+
+	samples.resize(resample_count);
+	std::atomic<unsigned int> next_resample(0);
+	auto worker = [&]() {
+		// A resample is stored as the multiplicity of every point; drawing it is a counting pass
+		// over the drawn indices, and fitting it sweeps the shared points in order
+		std::vector<double> multiplicity(count);
+		std::uniform_int_distribution<size_t> pick(0, count - 1);
+		for (unsigned int r = next_resample++; r < resample_count; r = next_resample++) {
+			std::mt19937_64 generator(seed * 0x9E3779B97F4A7C15ULL + r);
+			std::fill(multiplicity.begin(), multiplicity.end(), 0.0);
+			for (size_t i = 0; i < count; ++i) {
+				multiplicity[pick(generator)] += 1.0;
+			}
+			Fit_Result& sample = samples[r];
+			sample.center = full_fit.center;
+			sample.radius = full_fit.radius;
+			sample.is_computable = fit_weighted(multiplicity.data(), sample.center, sample.radius, resample_steps);
+		}
+	};
+
+	size_t workers = std::min<size_t>(thread_count, resample_count);
+	std::vector<std::thread> threads;
+	for (size_t t = 1; t < workers; ++t) {
+		threads.emplace_back(worker);
+	}
+	worker(); // Calling thread takes a share of the work
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	std::vector<double> center_xs, center_ys, radii;
+	for (auto& sample : samples) {
+		if (sample.is_computable)
+		{
+			center_xs.push_back(sample.center.x);
+			center_ys.push_back(sample.center.y);
+			radii.push_back(sample.radius);
+		}
+	}
+	if (radii.size() * tail < 1 - tail_rounding)
+		return false; // Too many resamples failed to leave a sample in each tail
+	std::sort(center_xs.begin(), center_xs.end());
+	std::sort(center_ys.begin(), center_ys.end());
+	std::sort(radii.begin(), radii.end());
+	center_x_interval = { get_quantile(center_xs, tail), get_quantile(center_xs, 1 - tail) };
+	center_y_interval = { get_quantile(center_ys, tail), get_quantile(center_ys, 1 - tail) };
+	radius_interval = { get_quantile(radii, tail), get_quantile(radii, 1 - tail) };
+	return true;
+}
+
+/**
+* returns the circle center of the full data fit
+*
+* @return center Center of the full data fit
+*/
+Circle_Center Bootstrap_Fitter::get_center_coordinate() {
+	return full_fit.center;
+}
+
+/**
+* returns the radius of the full data fit
+*
+* @return radius Radius of the full data fit
+*/
+double Bootstrap_Fitter::get_radius() {
+	return full_fit.radius;
+}
+
+/**
+* returns the confidence interval of the center x coordinate
+*
+* @return interval Lower and upper percentile bounds
+*/
+Confidence_Interval Bootstrap_Fitter::get_center_x_interval() {
+	return center_x_interval;
+}
+
+/**
+* returns the confidence interval of the center y coordinate
+*
+* @return interval Lower and upper percentile bounds
+*/
+Confidence_Interval Bootstrap_Fitter::get_center_y_interval() {
+	return center_y_interval;
+}
+
+/**
+* returns the confidence interval of the radius
+*
+* @return interval Lower and upper percentile bounds
+*/
+Confidence_Interval Bootstrap_Fitter::get_radius_interval() {
+	return radius_interval;
+}
+
+/**
+* returns the fit of every resample, in resample order
+*
+* @return samples Center, radius and state of every resample fit
+*/
+const std::vector<Fit_Result>& Bootstrap_Fitter::get_samples() {
+	return samples;
+}
+
+/**
+* returns the number of worker threads
+*
+* @return thread_count Number of worker threads
+*/
+unsigned int Bootstrap_Fitter::get_thread_count() {
+	return thread_count;
+}
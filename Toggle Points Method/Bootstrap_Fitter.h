@@ -0,0 +1,53 @@
+/*
+* @file Bootstrap_Fitter.h
+* @brief Header file for Bootstrap_Fitter which estimates the uncertainty of a best fit circle by
+* bootstrap resampling. The points are resampled with replacement many times, the circle is refitted
+* on each resample and percentile confidence intervals are taken for the center and radius.
+*
+* All resamples share one copy of the points. A resample is only the number of times each point was
+* drawn, and every resample fit starts from the full data fit. Resamples are spread over a pool of
+* worker threads.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include <vector>
+#include <cstdint>
+
+#pragma once
+#ifndef BOOTSTRAP_FITTER
+#define BOOTSTRAP_FITTER
+
+struct Confidence_Interval {
+	double lower;
+	double upper;
+};
+
+class Bootstrap_Fitter
+{
+private:
+	// Point buffer in structure of arrays layout, shared by every resample
+	std::vector<double> xs;
+	std::vector<double> ys;
+
+	unsigned int thread_count;
+	Fit_Result full_fit;
+	std::vector<Fit_Result> samples;
+	Confidence_Interval center_x_interval;
+	Confidence_Interval center_y_interval;
+	Confidence_Interval radius_interval;
+
+	bool fit_weighted(const double*, Circle_Center&, double&, int);
+public:
+
+	Bootstrap_Fitter(const std::vector<cv::Point>&, unsigned int thread_count = 0);
+	bool compute_bootstrap(unsigned int resample_count = 200, double confidence = 0.95, uint64_t seed = 1);
+	Circle_Center get_center_coordinate();
+	double get_radius();
+	Confidence_Interval get_center_x_interval();
+	Confidence_Interval get_center_y_interval();
+	Confidence_Interval get_radius_interval();
+	const std::vector<Fit_Result>& get_samples();
+	unsigned int get_thread_count();
+};
+#endif
@@ -0,0 +1,130 @@
+/*
+* @file Circle_Tracker.cpp
+* @brief Source file for Circle_Tracker which fits the same circle across consecutive frames of a
+* sequence, warm starting every frame from the previous one.
+*
+*/
+#include "Circle_Tracker.h"
+#include <cmath>
+
+/**
+* Constructor to setup the fallback rule
+*
+* @param residual_jump_ratio Refit from scratch if the RMS residual grows by more than this factor
+* @param min_residual RMS residual below which a frame is never considered a jump
+*
+*/
+Circle_Tracker::Circle_Tracker(double residual_jump_ratio, double min_residual) {
+	this->residual_jump_ratio = residual_jump_ratio;
+	this->min_residual = min_residual;
+	this->stats = Tracker_Stats();
+	reset();
+}
+
+/**
+* Forgets the tracked circle so that the next frame is fitted from scratch
+*/
+void Circle_Tracker::reset() {
+	has_track = false;
+	center.x = 0.0;
+	center.y = 0.0;
+	radius = 0.0;
+	rms_residual = 0.0;
+}
+
+/**
+* Fits the points of a frame with the point triplet initializer
+*
+* @param best_fit_circle Fitter setup with the points of the frame
+* @return result Center, radius and state of the fit
+*
+*/
+Fit_Result Circle_Tracker::fit_full(Best_Fitting_Circle& best_fit_circle) {
+	Fit_Result result;
+	++stats.full_fits;
+	result.is_computable = best_fit_circle.compute_best_fit_circle();
+	stats.iterations += best_fit_circle.get_iteration_count();
+	result.center = best_fit_circle.get_center_coordinate();
+	result.radius = best_fit_circle.get_radius();
+	return result;
+}
+
+/**
+* Fits the circle of the next frame. The previous circle is refined directly. If that does not converge, moves the center by more than the previous radius or
+* its RMS residual jumps compared to the previous frame, the frame is fitted again from scratch
+*
+* @param points Points of the frame
+* @return result Center, radius and state of the fit
+*
+*/
+Fit_Result Circle_Tracker::track(const std::vector<cv::Point>& points) {
+	Fit_Result result;
+	result.is_computable = false;
+	result.center = center;
+	result.radius = radius;
+	++stats.frames;
+	if (points.size() < 3)
+	{
+		reset();
+		return result;
+	}
+
+	Best_Fitting_Circle best_fit_circle(points);
+	best_fit_circle.set_verbose(false);
+	bool warm_start_accepted = false;
+	if (has_track)
+	{
+		++stats.warm_starts;
+		result.is_computable = best_fit_circle.refine_best_fit_circle(center);
+		stats.iterations += best_fit_circle.get_iteration_count();
+		double rms = sqrt(best_fit_circle.get_cost() / points.size());
+		Circle_Center refined = best_fit_circle.get_center_coordinate();
+		// The tracking window: a warm start that lands more than a radius away from the previous center lost the track
+		bool is_in_window = std::hypot(refined.x - center.x, refined.y - center.y) <= radius;
+		warm_start_accepted = result.is_computable && is_in_window && rms <= residual_jump_ratio * std::max(rms_residual, min_residual);
+		if (warm_start_accepted)
+		{
+			result.center = best_fit_circle.get_center_coordinate();
+			result.radius = best_fit_circle.get_radius();
+		}
+	}
+	if (!warm_start_accepted)
+	{
+		// First frame, or the circle moved too far to be tracked from the previous one
+		Best_Fitting_Circle full_fit(points);
+		full_fit.set_verbose(false);
+		result = fit_full(full_fit);
+		if (!result.is_computable)
+		{
+			reset();
+			return result;
+		}
+		rms_residual = sqrt(full_fit.get_cost() / points.size());
+	}
+	else
+	{
+		rms_residual = sqrt(best_fit_circle.get_cost() / points.size());
+	}
+	center = result.center;
+	radius = result.radius;
+	has_track = true;
+	return result;
+}
+
+/**
+* returns the counters of the tracker
+*
+* @return stats Frame, warm start, full fit and iteration counts
+*/
+Tracker_Stats Circle_Tracker::get_stats() {
+	return stats;
+}
+
+/**
+* returns the RMS distance between the last frame's points and its fitted circle
+*
+* @return rms_residual RMS residual
+*/
+double Circle_Tracker::get_rms_residual() {
+	return rms_residual;
+}
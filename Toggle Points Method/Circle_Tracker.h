@@ -0,0 +1,46 @@
+/*
+* @file Circle_Tracker.h
+* @brief Header file for Circle_Tracker which fits the same circle across consecutive frames of a
+* sequence. Each frame is warm started from the previous frame's circle, so the point triplet
+* initializer is skipped. A full
+* initialization is done on the first frame, whenever the circle moves by more than its radius
+* between frames and whenever the residual jumps.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include <vector>
+
+#pragma once
+#ifndef CIRCLE_TRACKER
+#define CIRCLE_TRACKER
+
+struct Tracker_Stats {
+	unsigned long long frames;
+	unsigned long long warm_starts;
+	unsigned long long full_fits; // First frames, lost tracks and fallbacks after a residual jump
+	unsigned long long iterations;
+};
+
+class Circle_Tracker
+{
+private:
+	double residual_jump_ratio;
+	double min_residual;
+
+	bool has_track;
+	Circle_Center center;
+	double radius;
+	double rms_residual;
+	Tracker_Stats stats;
+
+	Fit_Result fit_full(Best_Fitting_Circle&);
+public:
+
+	Circle_Tracker(double residual_jump_ratio = 3.0, double min_residual = 1.0);
+	Fit_Result track(const std::vector<cv::Point>&);
+	void reset();
+	Tracker_Stats get_stats();
+	double get_rms_residual();
+};
+#endif
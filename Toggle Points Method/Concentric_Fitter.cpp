@@ -0,0 +1,342 @@
+/*
+* @file Concentric_Fitter.cpp
+* @brief Source file for Concentric_Fitter which fits concentric circles with a shared center and
+* one radius per group of points.
+*
+* With r_g the mean distance of group g and u_i the unit vector from point i to the center, the
+* cost is the sum of (d_i - r_g)^2. Eliminating the radii from the Gauss-Newton normal equations
+* leaves a 2 x 2 system for the center step:
+*
+*     (sum u u^T - sum_g (sum_g u)(sum_g u)^T / n_g) step = -(sum (c - p) - sum_g r_g sum_g u)
+*
+* so a sweep only has to accumulate, per group, the distances, squared distances and unit vectors.
+*
+*/
+#include "Concentric_Fitter.h"
+#include "Parallel_Blocks.h"
+#include <thread>
+
+/*
+* Sums of one sweep for one group
+*/
+struct Ring_Sums {
+	double sd = 0, sdd = 0, sux = 0, suy = 0;
+};
+
+/*
+* Sums of one sweep shared by all the groups
+*/
+struct Center_Sums {
+	double sdx = 0, sdy = 0, uxx = 0, uxy = 0, uyy = 0;
+};
+
+/*
+* Sums of the algebraic fit x^2 + y^2 + a x + b y + c_g = 0 for one group
+*/
+struct Algebraic_Ring_Sums {
+	double sx = 0, sy = 0, sz = 0, sxx = 0, sxy = 0, syy = 0, sxz = 0, syz = 0;
+};
+
+/**
+* Constructor to copy the labeled points into the structure of arrays buffer. Points labeled -1,
+* or any negative label, belong to no group and are left out. If the label count does not match the
+* point count or a label is max_concentric_groups or more, no point is kept and the fit fails
+*
+* @param points Points of all the groups
+* @param labels Group of each point, from 0 to the number of groups - 1, negative for no group
+* @param thread_count Number of worker threads, 0 uses every available core
+*
+*/
+Concentric_Fitter::Concentric_Fitter(const std::vector<cv::Point>& points, const std::vector<int>& labels, unsigned int thread_count) {
+	if (points.size() == labels.size())
+	{
+		xs.reserve(points.size());
+		ys.reserve(points.size());
+		this->labels.reserve(points.size());
+		for (size_t i = 0; i < points.size(); ++i) {
+			if (labels[i] < 0)
+				continue; // Not part of any group
+			if ((size_t)labels[i] >= max_concentric_groups)
+			{
+				// A label this large is not a group index, reject the whole input
+				xs.clear();
+				ys.clear();
+				this->labels.clear();
+				group_counts.clear();
+				break;
+			}
+			xs.push_back(points[i].x);
+			ys.push_back(points[i].y);
+			this->labels.push_back((unsigned int)labels[i]);
+			if (this->labels.back() >= group_counts.size())
+				group_counts.resize(this->labels.back() + 1, 0.0);
+			group_counts[this->labels.back()] += 1;
+		}
+	}
+	radii.assign(group_counts.size(), 0.0);
+	if (thread_count == 0)
+		thread_count = std::thread::hardware_concurrency();
+	this->thread_count = (thread_count > 0) ? thread_count : 1;
+	this->circle_center_est.x = 0.0;
+	this->circle_center_est.y = 0.0;
+	this->cost = 0.0;
+	this->center_step_x = 0.0;
+	this->center_step_y = 0.0;
+	this->iteration_count = 0;
+	this->pass_count = 0;
+}
+
+/**
+* Estimates the shared center with an algebraic fit in one sweep. For fixed a and b the best c_g
+* makes each group's mean residual zero, which leaves a 2 x 2 system in the sums of each group
+* taken about its own mean
+*
+* @return true if the points do not all lie on one line
+*/
+bool Concentric_Fitter::initial_estimate() {
+	size_t group_count = group_counts.size();
+	std::vector<std::vector<Algebraic_Ring_Sums>> partial(thread_count, std::vector<Algebraic_Ring_Sums>(group_count));
+	const double origin_x = xs[0], origin_y = ys[0]; // Keeps the squared terms small
+	const double* x = xs.data();
+	const double* y = ys.data();
+	const unsigned int* label = labels.data();
+	unsigned int blocks = parallel_blocks(xs.size(), thread_count, [&](size_t begin, size_t end, unsigned int block) {
+		Algebraic_Ring_Sums* sums = partial[block].data();
+		for (size_t i = begin; i < end; ++i) {
+			double u = x[i] - origin_x;
+			double v = y[i] - origin_y;
+			double z = u * u + v * v;
+			Algebraic_Ring_Sums& ring = sums[label[i]];
+			ring.sx += u;
+			ring.sy += v;
+			ring.sz += z;
+			ring.sxx += u * u;
+			ring.sxy += u * v;
+			ring.syy += v * v;
+			ring.sxz += u * z;
+			ring.syz += v * z;
+		}
+	});
+
+	double cxx = 0, cxy = 0, cyy = 0, cxz = 0, cyz = 0;
+	for (size_t g = 0; g < group_count; ++g) {
+		if (group_counts[g] == 0)
+			continue;
+		Algebraic_Ring_Sums ring;
+		for (unsigned int b = 0; b < blocks; ++b) {
+			const Algebraic_Ring_Sums& part = partial[b][g];
+			ring.sx += part.sx;
+			ring.sy += part.sy;
+			ring.sz += part.sz;
+			ring.sxx += part.sxx;
+			ring.sxy += part.sxy;
+			ring.syy += part.syy;
+			ring.sxz += part.sxz;
+			ring.syz += part.syz;
+		}
+		double n = group_counts[g];
+		cxx += ring.sxx - ring.sx * ring.sx / n;
+		cxy += ring.sxy - ring.sx * ring.sy / n;
+		cyy += ring.syy - ring.sy * ring.sy / n;
+		cxz += ring.sxz - ring.sx * ring.sz / n;
+		cyz += ring.syz - ring.sy * ring.sz / n;
+	}
+	++pass_count;
+	double det = cxx * cyy - cxy * cxy;
+	if (std::abs(det) < 1.0e-12 * cxx * cyy || det == 0)
+		return false; // All the points are aligned
+	double a = -(cxz * cyy - cyz * cxy) / det;
+	double b = -(cyz * cxx - cxz * cxy) / det;
+	circle_center_est.x = origin_x - a / 2;
+	circle_center_est.y = origin_y - b / 2;
+	return true;
+}
+
+/**
+* Sweeps all the points once at a center and computes the radius of every group, the cost and the
+* Gauss-Newton step of the center
+*
+* @param center Center to evaluate
+* @return cost Sum of the squared residuals at the center
+*/
+double Concentric_Fitter::sum_pass(Circle_Center center) {
+	size_t group_count = group_counts.size();
+	std::vector<std::vector<Ring_Sums>> partial(thread_count, std::vector<Ring_Sums>(group_count));
+	std::vector<Center_Sums> partial_center(thread_count);
+	const double* x = xs.data();
+	const double* y = ys.data();
+	const unsigned int* label = labels.data();
+	unsigned int blocks = parallel_blocks(xs.size(), thread_count, [&](size_t begin, size_t end, unsigned int block) {
+		Ring_Sums* rings = partial[block].data();
+		Center_Sums sums;
+		for (size_t i = begin; i < end; ++i) {
+			double dx = center.x - x[i];
+			double dy = center.y - y[i];
+			double d = sqrt(dx * dx + dy * dy);
+			double inverse_d = (d > 0) ? 1.0 / d : 0.0;
+			double ux = dx * inverse_d;
+			double uy = dy * inverse_d;
+			Ring_Sums& ring = rings[label[i]];
+			ring.sd += d;
+			ring.sdd += d * d;
+			ring.sux += ux;
+			ring.suy += uy;
+			sums.sdx += dx;
+			sums.sdy += dy;
+			sums.uxx += ux * ux;
+			sums.uxy += ux * uy;
+			sums.uyy += uy * uy;
+		}
+		partial_center[block] = sums;
+	});
+
+	Center_Sums total;
+	for (unsigned int b = 0; b < blocks; ++b) {
+		total.sdx += partial_center[b].sdx;
+		total.sdy += partial_center[b].sdy;
+		total.uxx += partial_center[b].uxx;
+		total.uxy += partial_center[b].uxy;
+		total.uyy += partial_center[b].uyy;
+	}
+	double pass_cost = 0.0;
+	double gradient_x = total.sdx, gradient_y = total.sdy;
+	double sxx = total.uxx, sxy = total.uxy, syy = total.uyy;
+	for (size_t g = 0; g < group_count; ++g) {
+		if (group_counts[g] == 0)
+			continue;
+		Ring_Sums ring;
+		for (unsigned int b = 0; b < blocks; ++b) {
+			ring.sd += partial[b][g].sd;
+			ring.sdd += partial[b][g].sdd;
+			ring.sux += partial[b][g].sux;
+			ring.suy += partial[b][g].suy;
+		}
+		double n = group_counts[g];
+		radii[g] = ring.sd / n;
+		pass_cost += ring.sdd - ring.sd * radii[g];
+		gradient_x -= radii[g] * ring.sux;
+		gradient_y -= radii[g] * ring.suy;
+		sxx -= ring.sux * ring.sux / n;
+		sxy -= ring.sux * ring.suy / n;
+		syy -= ring.suy * ring.suy / n;
+	}
+	double det = sxx * syy - sxy * sxy;
+	if (det > 0)
+	{
+		center_step_x = -(syy * gradient_x - sxy * gradient_y) / det;
+		center_step_y = -(sxx * gradient_y - sxy * gradient_x) / det;
+	}
+	else
+	{
+		// Points of every group aligned with the center, fall back to a gradient step
+		center_step_x = -gradient_x / xs.size();
+		center_step_y = -gradient_y / xs.size();
+	}
+	++pass_count;
+	return std::max(0.0, pass_cost);
+}
+
+/**
+* Fits the shared center and the radius of every group. Each iteration takes the Gauss-Newton
+* step computed by the last sweep, halving it until the cost decreases; the sweep at the accepted
+* center already gives the step of the next iteration
+*
+* @return true if the circles are computable or else return false, also when the labels were
+* rejected by the constructor
+*
+*/
+bool Concentric_Fitter::compute_best_fit_circles() {
+	iteration_count = 0;
+	pass_count = 0;
+	if (xs.size() < 3 || !initial_estimate())
+		return false;
+	cost = sum_pass(circle_center_est);
+	double scale = 1.0;
+	for (auto radius : radii) {
+		scale = std::max(scale, radius);
+	}
+
+	for (int i = 0; i < 100; ++i) {
+		double step_x = center_step_x, step_y = center_step_y;
+		if (sqrt(step_x * step_x + step_y * step_y) < 1.0e-9 * scale || cost < 1.0e-10)
+			return true;
+		std::vector<double> previous_radii = radii;
+		double previous_cost = cost;
+		bool accepted = false;
+		for (int halving = 0; halving < 10 && !accepted; ++halving, step_x /= 2, step_y /= 2) {
+			Circle_Center next_center;
+			next_center.x = circle_center_est.x + step_x;
+			next_center.y = circle_center_est.y + step_y;
+			double next_cost = sum_pass(next_center);
+			if (next_cost <= previous_cost)
+			{
+				accepted = true;
+				circle_center_est = next_center;
+				cost = next_cost;
+			}
+		}
+		++iteration_count;
+		if (!accepted)
+		{
+			radii = previous_radii; // No decrease along the step
+			return true;
+		}
+		if ((previous_cost - cost) <= 1.0e-12 * previous_cost)
+			return true;
+	}
+	return true;
+}
+
+/**
+* returns the shared center of the circles
+*
+* @return circle_center_est Center coordinates
+*/
+Circle_Center Concentric_Fitter::get_center_coordinate() {
+	return circle_center_est;
+}
+
+/**
+* returns the radius of every group, 0 for labels with no points
+*
+* @return radii Radius of each group
+*/
+const std::vector<double>& Concentric_Fitter::get_radii() {
+	return radii;
+}
+
+/**
+* returns the sum of the squared residuals of all the points
+*
+* @return cost Cost value
+*/
+double Concentric_Fitter::get_cost() {
+	return cost;
+}
+
+/**
+* returns the number of groups, one more than the largest label
+*
+* @return group_count Number of groups
+*/
+size_t Concentric_Fitter::get_group_count() {
+	return group_counts.size();
+}
+
+/**
+* returns the number of Gauss-Newton iterations of the last fit
+*
+* @return iteration_count Number of iterations
+*/
+int Concentric_Fitter::get_iteration_count() {
+	return iteration_count;
+}
+
+/**
+* returns the number of sweeps over the points of the last fit
+*
+* @return pass_count Number of sweeps
+*/
+int Concentric_Fitter::get_pass_count() {
+	return pass_count;
+}
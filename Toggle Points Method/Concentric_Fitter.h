@@ -0,0 +1,53 @@
+/*
+* @file Concentric_Fitter.h
+* @brief Header file for Concentric_Fitter which fits concentric circles, such as the edges of a ring
+* or a washer, to labeled groups of points. All the groups share one center and each group has its
+* own radius, so every point constrains the common center.
+*
+* For a given center the best radius of each group is the mean distance of its points, so only the
+* center is iterated. Each Gauss-Newton iteration needs the per group sums of one sweep over all the
+* points, which is split over the worker threads.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include <vector>
+
+#pragma once
+#ifndef CONCENTRIC_FITTER
+#define CONCENTRIC_FITTER
+
+// Largest number of groups, labels must be below it
+const size_t max_concentric_groups = 1 << 16;
+
+class Concentric_Fitter
+{
+private:
+	// Point buffer in structure of arrays layout
+	std::vector<double> xs;
+	std::vector<double> ys;
+	std::vector<unsigned int> labels;
+	std::vector<double> group_counts;
+
+	unsigned int thread_count;
+	Circle_Center circle_center_est;
+	std::vector<double> radii;
+	double cost;
+	double center_step_x, center_step_y; // Gauss-Newton step from the last pass
+	int iteration_count;
+	int pass_count;
+
+	bool initial_estimate();
+	double sum_pass(Circle_Center);
+public:
+
+	Concentric_Fitter(const std::vector<cv::Point>&, const std::vector<int>&, unsigned int thread_count = 0);
+	bool compute_best_fit_circles();
+	Circle_Center get_center_coordinate();
+	const std::vector<double>& get_radii();
+	double get_cost();
+	size_t get_group_count();
+	int get_iteration_count();
+	int get_pass_count();
+};
+#endif
@@ -0,0 +1,341 @@
+/*
+* @file Extremal_Circle_Fitter.cpp
+* @brief Source file for Extremal_Circle_Fitter which computes the minimum enclosing circle and the
+* maximum inscribed circle of a point set.
+*
+*/
+#include "Extremal_Circle_Fitter.h"
+#include "Algebraic_Fit.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+const size_t no_point = std::numeric_limits<size_t>::max();
+
+// Moves allowed to the maximum inscribed circle, more are only taken around many cocircular points
+const int max_moves = 100;
+
+/**
+* Circle with two points on its diameter
+*/
+static void circle_from_two(cv::Point a, cv::Point b, Circle_Center& center, double& radius) {
+	center.x = (a.x + b.x) / 2.0;
+	center.y = (a.y + b.y) / 2.0;
+	radius = sqrt(pow(b.x - a.x, 2) + pow(b.y - a.y, 2)) / 2;
+}
+
+/**
+* Circle through three points. Aligned points have no such circle; the circle on the two farthest
+* apart then contains all three
+*/
+static void circle_from_three(cv::Point a, cv::Point b, cv::Point c, Circle_Center& center, double& radius) {
+	// Work relative to a to keep the products small
+	double bx = b.x - a.x, by = b.y - a.y;
+	double cx = c.x - a.x, cy = c.y - a.y;
+	double delta = 2 * (bx * cy - by * cx);
+	if (std::abs(delta) < 1.0e-10)
+	{
+		double ab = bx * bx + by * by, ac = cx * cx + cy * cy, bc = pow(c.x - b.x, 2) + pow(c.y - b.y, 2);
+		if (ab >= ac && ab >= bc)
+			circle_from_two(a, b, center, radius);
+		else if (ac >= bc)
+			circle_from_two(a, c, center, radius);
+		else
+			circle_from_two(b, c, center, radius);
+		return;
+	}
+	double b_sq = bx * bx + by * by;
+	double c_sq = cx * cx + cy * cy;
+	double ux = (cy * b_sq - by * c_sq) / delta;
+	double uy = (bx * c_sq - cx * b_sq) / delta;
+	center.x = a.x + ux;
+	center.y = a.y + uy;
+	radius = sqrt(ux * ux + uy * uy);
+}
+
+/**
+* Check to see if a point lies inside a circle, allowing for rounding on the boundary
+*/
+static bool is_inside(cv::Point point, Circle_Center center, double radius) {
+	double squared_distance = pow(point.x - center.x, 2) + pow(point.y - center.y, 2);
+	return squared_distance <= radius * radius * (1 + 1.0e-12) + 1.0e-9;
+}
+
+/**
+* Constructor to setup points and initialize circle center and radius. The points are not copied
+* and must outlive the fitter
+*
+* @param points Points list selected by the user
+*
+*/
+Extremal_Circle_Fitter::Extremal_Circle_Fitter(const std::vector<cv::Point>& points) : points(points) {
+	this->circle_center_est.x = 0.0;
+	this->circle_center_est.y = 0.0;
+	this->radius_estimate = 0.0;
+	this->move_count = 0;
+}
+
+/**
+* Computes the minimum enclosing circle with Welzl's algorithm in its iterative form. The points
+* are shuffled so that each new point lies outside the current circle with probability at most
+* 3 / i, which makes the expected time linear
+*
+* @param seed Seed of the shuffle
+* @return true if the points are not empty
+*
+*/
+bool Extremal_Circle_Fitter::compute_minimum_enclosing_circle(uint64_t seed) {
+	if (points.empty())
+		return false;
+	std::vector<cv::Point> shuffled(points);
+	std::mt19937_64 generator(seed);
+	std::shuffle(shuffled.begin(), shuffled.end(), generator);
+
+	Circle_Center center;
+	center.x = shuffled[0].x;
+	center.y = shuffled[0].y;
+	double radius = 0.0;
+	for (size_t i = 1; i < shuffled.size(); ++i) {
+		if (is_inside(shuffled[i], center, radius))
+			continue;
+		// Point i is on the boundary of the enclosing circle of the first i + 1 points
+		center.x = shuffled[i].x;
+		center.y = shuffled[i].y;
+		radius = 0.0;
+		for (size_t j = 0; j < i; ++j) {
+			if (is_inside(shuffled[j], center, radius))
+				continue;
+			// Points i and j are both on the boundary
+			circle_from_two(shuffled[i], shuffled[j], center, radius);
+			for (size_t k = 0; k < j; ++k) {
+				if (!is_inside(shuffled[k], center, radius))
+					circle_from_three(shuffled[i], shuffled[j], shuffled[k], center, radius);
+			}
+		}
+	}
+	circle_center_est = center;
+	radius_estimate = radius;
+	return true;
+}
+
+/**
+* Finds the point nearest to a center
+*
+* @param center Center to search from
+* @param distance Set to the distance of the nearest point
+* @return index of the nearest point
+*/
+size_t Extremal_Circle_Fitter::find_nearest_point(Circle_Center center, double& distance) {
+	size_t nearest = no_point;
+	double nearest_squared = std::numeric_limits<double>::infinity();
+	for (size_t i = 0; i < points.size(); ++i) {
+		double dx = points[i].x - center.x;
+		double dy = points[i].y - center.y;
+		double squared = dx * dx + dy * dy;
+		if (squared < nearest_squared)
+		{
+			nearest_squared = squared;
+			nearest = i;
+		}
+	}
+	distance = sqrt(nearest_squared);
+	return nearest;
+}
+
+/**
+* Moving the center along direction from a point where the contact points are at the given
+* radius, finds the first other point that becomes as near as the contacts. For a point q and
+* contact a, |center + t direction - q| = |center + t direction - a| gives
+* t = (|center - q|^2 - radius^2) / (2 direction . (q - a)), and q can only block when the
+* denominator is positive
+*
+* @param center Current center
+* @param radius Distance from the center to the contact points
+* @param direction Direction of the move
+* @param contacts Indices of the contact points
+* @param contact_count Number of contact points
+* @param step Set to the length of the move along direction
+* @return index of the blocking point, no_point if nothing blocks the move
+*/
+size_t Extremal_Circle_Fitter::find_blocking_point(Circle_Center center, double radius, Gradient direction, const size_t* contacts, int contact_count, double& step) {
+	const cv::Point a = points[contacts[0]];
+	size_t blocking = no_point;
+	step = std::numeric_limits<double>::infinity();
+	for (size_t i = 0; i < points.size(); ++i) {
+		double denominator = direction.x * (points[i].x - a.x) + direction.y * (points[i].y - a.y);
+		if (denominator <= 0)
+			continue;
+		double dx = points[i].x - center.x;
+		double dy = points[i].y - center.y;
+		double t = std::max(0.0, (dx * dx + dy * dy - radius * radius) / (2 * denominator));
+		if (t < step && std::find(contacts, contacts + contact_count, i) == contacts + contact_count)
+		{
+			step = t;
+			blocking = i;
+		}
+	}
+	return blocking;
+}
+
+/**
+* Computes the maximum inscribed circle. From the least squares center the fitter moves straight
+* away from the nearest point until a second point is as near, then along the bisector of the two
+* contacts, a Voronoi edge, until a third point is as near. That is a Voronoi vertex: it is the
+* maximum if its nearest points surround it, otherwise the climb continues along the next edge
+*
+* @return true if the points surround a bounded inscribed circle and the climb reached it within
+* max_moves moves
+*
+*/
+bool Extremal_Circle_Fitter::compute_maximum_inscribed_circle() {
+	move_count = 0;
+	if (points.size() < 3)
+		return false;
+	Algebraic_Fit algebraic_fit;
+	for (auto point : points) {
+		algebraic_fit.add(point.x, point.y);
+	}
+	Circle_Center center;
+	double radius;
+	if (!algebraic_fit.solve(center, radius))
+		return false;
+
+	size_t contacts[3];
+	contacts[0] = find_nearest_point(center, radius);
+	if (contacts[0] == no_point || !std::isfinite(center.x) || !std::isfinite(center.y))
+		return false; // No distance to the center compares, it is not a finite point
+	if (radius <= 0)
+		return false; // Center is on a point
+
+	// Move straight away from the nearest point
+	Gradient direction;
+	direction.x = (center.x - points[contacts[0]].x) / radius;
+	direction.y = (center.y - points[contacts[0]].y) / radius;
+	double step;
+	contacts[1] = find_blocking_point(center, radius, direction, contacts, 1, step);
+	if (contacts[1] == no_point)
+		return false; // The points do not surround the center
+	center.x += step * direction.x;
+	center.y += step * direction.y;
+	radius += step;
+	++move_count;
+
+	// Side of the contacts' chord to climb towards, first the side of the center
+	Gradient heading;
+	heading.x = center.x - points[contacts[0]].x;
+	heading.y = center.y - points[contacts[0]].y;
+	bool is_maximum = false;
+	while (move_count < max_moves) {
+		// Move along the bisector of the two contacts
+		cv::Point a = points[contacts[0]];
+		cv::Point b = points[contacts[1]];
+		double length = sqrt(pow(b.x - a.x, 2) + pow(b.y - a.y, 2));
+		direction.x = -(b.y - a.y) / length;
+		direction.y = (b.x - a.x) / length;
+		if (direction.x * heading.x + direction.y * heading.y < 0)
+		{
+			direction.x = -direction.x;
+			direction.y = -direction.y;
+		}
+		contacts[2] = find_blocking_point(center, radius, direction, contacts, 2, step);
+		if (contacts[2] == no_point)
+			return false; // The points do not surround the center
+		center.x += step * direction.x;
+		center.y += step * direction.y;
+		radius = sqrt(pow(center.x - a.x, 2) + pow(center.y - a.y, 2));
+		++move_count;
+
+		// A vertex is the maximum when its nearest points surround it, i.e. every angular gap between
+		// them is less than a half turn. Otherwise the climb continues along the Voronoi edge of the
+		// two points bounding the largest gap, into the gap. With three contacts this is a vertex
+		// outside their triangle; checking every equidistant point also covers cocircular points,
+		// and a gap of exactly a half turn, two opposite contacts, still climbs
+		std::vector<std::pair<double, size_t>> angles;
+		for (size_t i = 0; i < points.size(); ++i) {
+			double dx = points[i].x - center.x;
+			double dy = points[i].y - center.y;
+			if (dx * dx + dy * dy <= radius * radius * (1 + 1.0e-9))
+				angles.push_back(std::make_pair(atan2(dy, dx), i));
+		}
+		if (angles.empty())
+			return false;
+		std::sort(angles.begin(), angles.end());
+		double largest_gap = angles.front().first + 2 * CV_PI - angles.back().first;
+		double gap_start = angles.back().first;
+		contacts[0] = angles.back().second;
+		contacts[1] = angles.front().second;
+		for (size_t i = 1; i < angles.size(); ++i) {
+			if (angles[i].first - angles[i - 1].first > largest_gap)
+			{
+				largest_gap = angles[i].first - angles[i - 1].first;
+				gap_start = angles[i - 1].first;
+				contacts[0] = angles[i - 1].second;
+				contacts[1] = angles[i].second;
+			}
+		}
+		if (largest_gap < CV_PI * (1 - 1.0e-9))
+		{
+			is_maximum = true; // Local maximum
+			break;
+		}
+		heading.x = cos(gap_start + largest_gap / 2);
+		heading.y = sin(gap_start + largest_gap / 2);
+	}
+
+	if (!is_maximum)
+		return false; // Out of moves before reaching a maximum
+
+	// The moves keep the contacts nearest; take the radius from one more sweep to absorb rounding
+	circle_center_est = center;
+	find_nearest_point(center, radius_estimate);
+	return true;
+}
+
+/**
+* returns the circle's radius
+*
+* @return radius_estimate Radius of the circle
+*/
+double Extremal_Circle_Fitter::get_radius() {
+	return radius_estimate;
+}
+
+/**
+* returns the circle's center coordinates
+*
+* @return circle_center_est Center of the circle
+*/
+Circle_Center Extremal_Circle_Fitter::get_center_coordinate() {
+	return circle_center_est;
+}
+
+/**
+* returns the number of moves taken by the last maximum inscribed circle
+*
+* @return move_count Number of moves
+*/
+int Extremal_Circle_Fitter::get_move_count() {
+	return move_count;
+}
+
+/**
+* Fits a circle to a point set with the given mode
+*
+* @param points Points list selected by the user
+* @param mode Least squares, minimum enclosing or maximum inscribed circle
+* @return result Center, radius and state of the fit
+*/
+Fit_Result fit_circle(const std::vector<cv::Point>& points, Fit_Mode mode) {
+	Fit_Result result;
+	if (mode == least_squares_fit)
+	{
+		return fit_best_circle(points);
+	}
+	Extremal_Circle_Fitter extremal_circle_fitter(points);
+	result.is_computable = (mode == minimum_enclosing_fit) ? extremal_circle_fitter.compute_minimum_enclosing_circle()
+		: extremal_circle_fitter.compute_maximum_inscribed_circle();
+	result.center = extremal_circle_fitter.get_center_coordinate();
+	result.radius = extremal_circle_fitter.get_radius();
+	return result;
+}
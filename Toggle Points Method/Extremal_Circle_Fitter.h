@@ -0,0 +1,52 @@
+/*
+* @file Extremal_Circle_Fitter.h
+* @brief Header file for Extremal_Circle_Fitter which computes the minimum enclosing circle and the
+* maximum inscribed circle of a point set, the outer and inner envelopes used in inspection next to
+* the least squares circle.
+*
+* The minimum enclosing circle is the smallest circle containing every point. It is found with
+* Welzl's randomized incremental algorithm in expected linear time.
+*
+* The maximum inscribed circle is the largest circle with no point inside whose center lies in the
+* region surrounded by the points. Its center is the Voronoi vertex that locally maximizes the
+* distance to the nearest point. Starting from the least squares center, the fitter climbs along
+* Voronoi edges to that vertex with one sweep of the points per move.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include <vector>
+#include <cstdint>
+
+#pragma once
+#ifndef EXTREMAL_CIRCLE_FITTER
+#define EXTREMAL_CIRCLE_FITTER
+
+enum Fit_Mode {
+	least_squares_fit,
+	minimum_enclosing_fit,
+	maximum_inscribed_fit
+};
+
+class Extremal_Circle_Fitter
+{
+private:
+	const std::vector<cv::Point>& points;
+	double radius_estimate;
+	Circle_Center circle_center_est;
+	int move_count;
+
+	size_t find_nearest_point(Circle_Center, double&);
+	size_t find_blocking_point(Circle_Center, double, Gradient, const size_t*, int, double&);
+public:
+
+	Extremal_Circle_Fitter(const std::vector<cv::Point>&);
+	bool compute_minimum_enclosing_circle(uint64_t seed = 1);
+	bool compute_maximum_inscribed_circle();
+	double get_radius();
+	Circle_Center get_center_coordinate();
+	int get_move_count();
+};
+
+Fit_Result fit_circle(const std::vector<cv::Point>&, Fit_Mode);
+#endif
@@ -0,0 +1,74 @@
+/*
+* @file Fit_Budget.h
+* @brief Limits for anytime fits: a time budget, an iteration budget and a target RMS residual.
+* A fit that runs out of budget stops and keeps the best circle found so far. Fit_Deadline checks
+* the clock only once enough points have been swept since the last check, so small and large fits
+* pay the same small share of their time for it.
+*
+*/
+
+#include <chrono>
+#include <cstddef>
+
+#pragma once
+#ifndef FIT_BUDGET
+#define FIT_BUDGET
+
+struct Fit_Budget {
+	std::chrono::steady_clock::duration time_budget = std::chrono::steady_clock::duration::zero(); // Zero for no deadline
+	int max_iterations = 0; // Line search steps, 0 for no limit
+	double target_rms = 0.0; // Stop once the RMS residual is at most this, 0 to run until converged
+};
+
+// Why an anytime fit stopped
+enum Fit_Stop {
+	stopped_converged,
+	stopped_target_rms,
+	stopped_deadline,
+	stopped_iteration_budget,
+	stopped_not_converged,
+	stopped_failed
+};
+
+class Fit_Deadline
+{
+private:
+	// Points swept between two reads of the clock
+	static const size_t points_per_clock_check = 4096;
+
+	std::chrono::steady_clock::time_point deadline;
+	bool has_deadline = false;
+	bool expired = false;
+	size_t next_check = 0;
+public:
+
+	Fit_Deadline() {}
+
+	/**
+	* Constructor to start the deadline
+	*
+	* @param time_budget Time allowed from start, zero for no deadline
+	* @param start Time the fit started
+	*
+	*/
+	Fit_Deadline(std::chrono::steady_clock::duration time_budget, std::chrono::steady_clock::time_point start) {
+		has_deadline = time_budget > std::chrono::steady_clock::duration::zero();
+		deadline = start + time_budget;
+	}
+
+	/**
+	* Tells whether the deadline has passed. The clock is read at most once per
+	* points_per_clock_check swept points, and on every call after a sweep of more points
+	*
+	* @param points_swept Total number of points swept by the fit so far
+	* @return true once the deadline has passed
+	*/
+	bool has_expired(size_t points_swept) {
+		if (!has_deadline || expired || points_swept < next_check)
+			return expired;
+		next_check = points_swept + points_per_clock_check;
+		expired = std::chrono::steady_clock::now() >= deadline;
+		return expired;
+	}
+};
+#endif
@@ -0,0 +1,188 @@
+/*
+* @file Fit_Cache.cpp
+* @brief Source file for Fit_Cache, a bounded least recently used cache of best fit circle results,
+* and Point_Set_Hash, the Zobrist style hash of a point set used as its key.
+*
+*/
+#include "Fit_Cache.h"
+
+/**
+* Returns the Zobrist key of a point. The key is derived from the coordinates with the
+* splitmix64 finalizer so no key table has to be stored for arbitrary coordinates
+*
+* @param point Point coordinates
+* @return key Pseudo random key of the point
+*
+*/
+uint64_t Point_Set_Hash::get_point_key(cv::Point point) {
+	uint64_t key = ((uint64_t)(uint32_t)point.x << 32) | (uint32_t)point.y;
+	key += 0x9E3779B97F4A7C15ULL;
+	key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+	return key ^ (key >> 31);
+}
+
+/**
+* Computes the hash of a whole point set
+*
+* @param points Points of the set
+* @return set_hash Hash of the point set
+*
+*/
+Point_Set_Hash Point_Set_Hash::of(const std::vector<cv::Point>& points) {
+	Point_Set_Hash set_hash;
+	for (auto point : points) {
+		set_hash.add(point);
+	}
+	return set_hash;
+}
+
+/**
+* Adds a point to the hashed set
+*
+* @param point Point that was selected
+*/
+void Point_Set_Hash::add(cv::Point point) {
+	hash += get_point_key(point);
+	++count;
+}
+
+/**
+* Removes a point from the hashed set
+*
+* @param point Point that was deselected
+*/
+void Point_Set_Hash::remove(cv::Point point) {
+	hash -= get_point_key(point);
+	--count;
+}
+
+/**
+* Resets the hash to the empty set
+*/
+void Point_Set_Hash::clear() {
+	hash = 0;
+	count = 0;
+}
+
+/**
+* returns the hash value of the set
+*
+* @return hash Hash value
+*/
+uint64_t Point_Set_Hash::get_hash() const {
+	return hash;
+}
+
+/**
+* returns the number of points in the set
+*
+* @return count Number of points
+*/
+size_t Point_Set_Hash::get_count() const {
+	return count;
+}
+
+/**
+* Two sets are considered equal when both their hash and their size match
+*/
+bool Point_Set_Hash::operator==(const Point_Set_Hash& other) const {
+	return hash == other.hash && count == other.count;
+}
+
+/**
+* Constructor to setup the maximum number of cached results
+*
+* @param capacity Maximum number of entries before the least recently used one is evicted
+*
+*/
+Fit_Cache::Fit_Cache(size_t capacity) {
+	this->capacity = (capacity > 0) ? capacity : 1;
+}
+
+/**
+* Looks up the fit result of a point set and marks it as most recently used
+*
+* @param key Hash of the point set
+* @param result Cached result, only written on a hit
+* @return true if the result was cached
+*
+*/
+bool Fit_Cache::lookup(const Point_Set_Hash& key, Fit_Result& result) {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	auto found = index.find(key.get_hash());
+	if (found == index.end() || !(found->second->first == key))
+	{
+		++misses;
+		return false;
+	}
+	entries.splice(entries.begin(), entries, found->second); // Move to the front of the LRU list
+	result = found->second->second;
+	++hits;
+	return true;
+}
+
+/**
+* Stores the fit result of a point set, evicting the least recently used entry if the cache is full
+*
+* @param key Hash of the point set
+* @param result Fit result to store
+*
+*/
+void Fit_Cache::insert(const Point_Set_Hash& key, const Fit_Result& result) {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	auto found = index.find(key.get_hash());
+	if (found != index.end())
+	{
+		found->second->first = key;
+		found->second->second = result;
+		entries.splice(entries.begin(), entries, found->second);
+		return;
+	}
+	if (entries.size() >= capacity)
+	{
+		index.erase(entries.back().first.get_hash());
+		entries.pop_back();
+	}
+	entries.emplace_front(key, result);
+	index[key.get_hash()] = entries.begin();
+}
+
+/**
+* Removes all the cached results. The hit and miss counters are kept
+*/
+void Fit_Cache::clear() {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	entries.clear();
+	index.clear();
+}
+
+/**
+* returns the number of cached results
+*
+* @return size Number of entries
+*/
+size_t Fit_Cache::get_size() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return entries.size();
+}
+
+/**
+* returns the number of lookups that found a cached result
+*
+* @return hits Hit count
+*/
+unsigned long long Fit_Cache::get_hits() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return hits;
+}
+
+/**
+* returns the number of lookups that did not find a cached result
+*
+* @return misses Miss count
+*/
+unsigned long long Fit_Cache::get_misses() const {
+	std::lock_guard<std::mutex> lock(cache_mutex);
+	return misses;
+}
@@ -0,0 +1,63 @@
+/*
+* @file Fit_Cache.h
+* @brief Header file for Fit_Cache, a bounded least recently used cache of best fit circle results,
+* and Point_Set_Hash, the Zobrist style hash of a point set used as its key.
+*
+* Every point maps to a fixed pseudo random 64 bit key and the hash of a set is the sum of the keys
+* of its points, so adding or removing a point updates the hash in O(1) and the hash does not depend
+* on the order in which the points were selected. Summing rather than xoring keeps a point that is
+* listed twice from cancelling itself out.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#pragma once
+#ifndef FIT_CACHE
+#define FIT_CACHE
+
+class Point_Set_Hash
+{
+private:
+	uint64_t hash = 0;
+	size_t count = 0;
+public:
+
+	static uint64_t get_point_key(cv::Point);
+	static Point_Set_Hash of(const std::vector<cv::Point>&);
+	void add(cv::Point);
+	void remove(cv::Point);
+	void clear();
+	uint64_t get_hash() const;
+	size_t get_count() const;
+	bool operator==(const Point_Set_Hash&) const;
+};
+
+class Fit_Cache
+{
+private:
+	typedef std::pair<Point_Set_Hash, Fit_Result> Cache_Entry;
+
+	size_t capacity;
+	std::list<Cache_Entry> entries; // Most recently used entry first
+	std::unordered_map<uint64_t, std::list<Cache_Entry>::iterator> index;
+	unsigned long long hits = 0;
+	unsigned long long misses = 0;
+	mutable std::mutex cache_mutex;
+public:
+
+	Fit_Cache(size_t capacity = 1024);
+	bool lookup(const Point_Set_Hash&, Fit_Result&);
+	void insert(const Point_Set_Hash&, const Fit_Result&);
+	void clear();
+	size_t get_size() const;
+	unsigned long long get_hits() const;
+	unsigned long long get_misses() const;
+};
+#endif
@@ -0,0 +1,27 @@
+/*
+* @file Geometry.h
+* @brief Small geometry helpers shared by the fitters and both interactive front ends.
+*
+*/
+
+#include <cmath>
+
+#pragma once
+#ifndef GEOMETRY
+#define GEOMETRY
+
+/**
+ * Calculates the distance between two coordinates
+ *
+ *
+ * @param x1 First coordinate's x value
+ * @param x2 Second coordinate's x value
+ * @param y1 First coordinate's y value
+ * @param y2 Second coordinate's y value
+ * @return distance between the coordinate points
+ *
+ */
+inline double get_distance(const double x1, const double x2, const double y1, const double y2) {
+	return std::sqrt((y2 - y1) * (y2 - y1) + (x2 - x1) * (x2 - x1));
+}
+#endif
@@ -0,0 +1,169 @@
+/*
+* @file Grid_Model.cpp
+* @brief Source file for Grid_Model, the grid of points shared by both interactive front ends. It
+* lays out the grid, finds the grid point under a mouse click, keeps the toggled points in
+* selection order together with their hash, and draws the grid onto an image.
+*
+*/
+#include "Grid_Model.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+/**
+* Constructor to lay out the grid. Grid point (i, j) sits at ((i + 1) * grid_spacing, (j + 1) * grid_spacing)
+*
+* @param grid_spacing Space between the grid points
+* @param grid_size Number of grid points in each row and column
+*
+*/
+Grid_Model::Grid_Model(unsigned int grid_spacing, int grid_size) {
+	this->grid_spacing = grid_spacing;
+	this->grid_size = grid_size;
+	grid_points.resize((size_t)grid_size * grid_size);
+	for (int i = 0; i < grid_size; ++i) {
+		for (int j = 0; j < grid_size; ++j) {
+			get_grid_point(i, j).set_params(cv::Point(grid_spacing * (i + 1), grid_spacing * (j + 1)), false);
+		}
+	}
+}
+
+/**
+* Finds the grid point whose marker contains the given coordinates
+*
+* @param x x coordinate of the mouse click
+* @param y y coordinate of the mouse click
+* @param i Column of the grid point found
+* @param j Row of the grid point found
+* @return true if the coordinates overlap a grid point
+*
+*/
+bool Grid_Model::find_grid_point(int x, int y, int& i, int& j) const {
+	if (x < 0 || y < 0 || (int)(x % grid_spacing) >= marker_size || (int)(y % grid_spacing) >= marker_size)
+		return false;
+	i = (int)(x / grid_spacing) - 1;
+	j = (int)(y / grid_spacing) - 1;
+	return i >= 0 && i < grid_size && j >= 0 && j < grid_size;
+}
+
+/**
+* returns the grid point at the given column and row
+*
+* @param i Column of the grid point
+* @param j Row of the grid point
+* @return grid_point Grid point
+*/
+Grid_Points& Grid_Model::get_grid_point(int i, int j) {
+	return grid_points[(size_t)i * grid_size + j];
+}
+const Grid_Points& Grid_Model::get_grid_point(int i, int j) const {
+	return grid_points[(size_t)i * grid_size + j];
+}
+
+/**
+* Toggles a grid point and adds it to or removes it from the selected points and their hash
+*
+* @param i Column of the grid point
+* @param j Row of the grid point
+* @return true if the grid point is selected after the toggle
+*
+*/
+bool Grid_Model::toggle(int i, int j) {
+	Grid_Points& grid_point = get_grid_point(i, j);
+	grid_point.toggle(selection_hash);
+	if (grid_point.get_is_selected())
+	{
+		selected_points.push_back(grid_point.point);
+	}
+	else
+	{
+		// Remove the point from the selected points, keeping the order of the others
+		selected_points.erase(std::remove(selected_points.begin(), selected_points.end(), grid_point.point), selected_points.end());
+	}
+	return grid_point.get_is_selected();
+}
+
+/**
+* Deselects every grid point so that the next click selects them again
+*
+*/
+void Grid_Model::clear_selection() {
+	for (auto& grid_point : grid_points) {
+		if (grid_point.get_is_selected())
+			grid_point.toggle();
+	}
+	selected_points.clear();
+	selection_hash.clear();
+}
+
+/**
+* Draws every grid point in the color of its state
+*
+* @param image Image to draw on
+*/
+void Grid_Model::draw(cv::Mat& image) const {
+	for (int i = 0; i < grid_size; ++i) {
+		for (int j = 0; j < grid_size; ++j) {
+			draw_point(image, i, j);
+		}
+	}
+}
+
+/**
+* Draws one grid point in the color of its state
+*
+* @param image Image to draw on
+* @param i Column of the grid point
+* @param j Row of the grid point
+*/
+void Grid_Model::draw_point(cv::Mat& image, int i, int j) const {
+	draw_point(image, i, j, get_grid_point(i, j).color);
+}
+
+/**
+* Draws one grid point in the given color
+*
+* @param image Image to draw on
+* @param i Column of the grid point
+* @param j Row of the grid point
+* @param color Color of the marker
+*/
+void Grid_Model::draw_point(cv::Mat& image, int i, int j, const cv::Scalar& color) const {
+	const Grid_Points& grid_point = get_grid_point(i, j);
+	cv::rectangle(image, grid_point.point, grid_point.grid_offset, color, -1, 8, 0);
+}
+
+/**
+* returns the selected points in the order they were selected
+*
+* @return selected_points Selected points
+*/
+const std::vector<cv::Point>& Grid_Model::get_selected_points() const {
+	return selected_points;
+}
+
+/**
+* returns the hash of the selected points, the key of their fit in a Fit_Cache
+*
+* @return selection_hash Hash of the selected points
+*/
+const Point_Set_Hash& Grid_Model::get_selection_hash() const {
+	return selection_hash;
+}
+
+/**
+* returns the space between the grid points
+*
+* @return grid_spacing Space between the grid points
+*/
+unsigned int Grid_Model::get_grid_spacing() const {
+	return grid_spacing;
+}
+
+/**
+* returns the number of grid points in each row and column
+*
+* @return grid_size Number of grid points
+*/
+int Grid_Model::get_grid_size() const {
+	return grid_size;
+}
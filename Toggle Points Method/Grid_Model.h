@@ -0,0 +1,45 @@
+/*
+* @file Grid_Model.h
+* @brief Header file for Grid_Model, the grid of points shared by both interactive front ends. It
+* lays out the grid, finds the grid point under a mouse click, keeps the toggled points in
+* selection order together with their hash, and draws the grid onto an image. It has no window
+* or mouse handling of its own.
+*
+*/
+
+#include <opencv2/core.hpp>
+#include "Grid_Points.h"
+#include "Fit_Cache.h"
+#include <vector>
+
+#pragma once
+#ifndef GRID_MODEL
+#define GRID_MODEL
+
+class Grid_Model
+{
+private:
+	unsigned int grid_spacing;
+	int grid_size;
+	std::vector<Grid_Points> grid_points; // Column by column, grid point (i, j) at i * grid_size + j
+	std::vector<cv::Point> selected_points; // In selection order
+	Point_Set_Hash selection_hash;
+public:
+	// Width and height of a drawn grid point, and of the area that selects it
+	static const int marker_size = 5;
+
+	Grid_Model(unsigned int grid_spacing = 40, int grid_size = 20);
+	bool find_grid_point(int x, int y, int& i, int& j) const;
+	Grid_Points& get_grid_point(int i, int j);
+	const Grid_Points& get_grid_point(int i, int j) const;
+	bool toggle(int i, int j);
+	void clear_selection();
+	void draw(cv::Mat&) const;
+	void draw_point(cv::Mat&, int i, int j) const;
+	void draw_point(cv::Mat&, int i, int j, const cv::Scalar&) const;
+	const std::vector<cv::Point>& get_selected_points() const;
+	const Point_Set_Hash& get_selection_hash() const;
+	unsigned int get_grid_spacing() const;
+	int get_grid_size() const;
+};
+#endif
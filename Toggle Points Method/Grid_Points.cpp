@@ -38,6 +38,19 @@ void Grid_Points::toggle() {
 	}
 }
 
+/**
+* Toggles the state of the grid point and updates the hash of the selected point set in O(1)
+*
+* @param selection_hash Hash of the currently selected points
+*/
+void Grid_Points::toggle(Point_Set_Hash& selection_hash) {
+	toggle();
+	if (is_selected)
+		selection_hash.add(point);
+	else
+		selection_hash.remove(point);
+}
+
 /**
 * returns the state of the grid point
 *
@@ -5,7 +5,8 @@
 * @author: Praneeth Eddu
 * Contact: praneetheddu@gatech.edu
 */
-#include <opencv2/opencv.hpp>
+#include <opencv2/core.hpp>
+#include "Fit_Cache.h"
 
 #pragma once
 #ifndef GRID_POINTS
@@ -20,6 +21,7 @@ public:
 	cv::Scalar color;
 	void set_params(cv::Point, bool);
 	void toggle();
+	void toggle(Point_Set_Hash&);
 	bool get_is_selected();
 };
 
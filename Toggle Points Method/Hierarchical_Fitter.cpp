@@ -0,0 +1,153 @@
+/*
+* @file Hierarchical_Fitter.cpp
+* @brief Source file for Hierarchical_Fitter which fits very large point sets coarse to fine,
+* from a small stratified subsample up to the full point set.
+*
+*/
+#include "Hierarchical_Fitter.h"
+#include "Hypersphere_Fitter.h"
+#include <chrono>
+#include <random>
+
+/**
+* Constructor to setup the points and the level schedule. The points are not copied and must
+* outlive the fitter
+*
+* @param points Full point set
+* @param tolerance Center and radius change between two levels below which the estimate is
+* considered stable and the remaining levels are skipped
+* @param base_size Number of points of the first level, which runs the point triplet initializer
+* @param growth Factor between the sizes of consecutive levels
+*
+*/
+Hierarchical_Fitter::Hierarchical_Fitter(const std::vector<cv::Point>& points, double tolerance, size_t base_size, size_t growth)
+	: points(points) {
+	this->tolerance = tolerance;
+	this->base_size = (base_size >= 3) ? base_size : 3;
+	this->growth = (growth >= 2) ? growth : 2;
+	this->circle_center_est.x = 0.0;
+	this->circle_center_est.y = 0.0;
+	this->radius_estimate = 0.0;
+}
+
+/**
+* Picks one point from each of sample_size equally sized strata of the point set. The position
+* inside each stratum is random so that regular patterns in the input order are not aliased
+*
+* @param sample_size Number of points to pick
+* @param seed Seed of the position generator
+* @return sample Stratified subsample
+*
+*/
+std::vector<cv::Point> Hierarchical_Fitter::stratified_sample(size_t sample_size, unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::vector<cv::Point> sample(sample_size);
+	double stratum = (double)points.size() / sample_size;
+	std::uniform_real_distribution<double> offset(0.0, stratum);
+	for (size_t i = 0; i < sample_size; ++i) {
+		size_t index = (size_t)(i * stratum + offset(generator));
+		sample[i] = points[std::min(index, points.size() - 1)];
+	}
+	return sample;
+}
+
+/**
+* Fits one level, from scratch for the first level and from the previous level's center otherwise.
+* The first level is a small sample fitted by Best_Fitting_Circle, the others are refined by
+* Hypersphere_Fitter on the level's points in place, so the full set is never copied. The previous
+* radius is passed on as the reference radius, which saves the engine one sweep per level
+*
+* @param level_points Points of the level
+* @param is_first_level true to run the point triplet initializer
+* @return true if the level converged
+*
+*/
+bool Hierarchical_Fitter::fit_level(const std::vector<cv::Point>& level_points, bool is_first_level) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Fit_Level level;
+	level.point_count = level_points.size();
+	bool is_computable;
+	if (is_first_level)
+	{
+		Best_Fitting_Circle best_fit_circle(level_points);
+		best_fit_circle.set_verbose(false);
+		best_fit_circle.set_step_tolerance(tolerance);
+		is_computable = best_fit_circle.compute_best_fit_circle();
+		level.iterations = best_fit_circle.get_iteration_count();
+		level.center = best_fit_circle.get_center_coordinate();
+		level.radius = best_fit_circle.get_radius();
+	}
+	else
+	{
+		Hypersphere_Fitter<2, Point_View<2, cv::Point>> engine(level_points);
+		engine.set_step_tolerance(tolerance);
+		is_computable = engine.refine_best_fit_sphere({ circle_center_est.x, circle_center_est.y }, radius_estimate);
+		level.iterations = engine.get_iteration_count();
+		level.center.x = engine.get_center()[0];
+		level.center.y = engine.get_center()[1];
+		level.radius = engine.get_radius();
+	}
+	level.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	levels.push_back(level);
+	if (is_computable)
+	{
+		circle_center_est = level.center;
+		radius_estimate = level.radius;
+	}
+	return is_computable;
+}
+
+/**
+* Fits the circle coarse to fine. Each level is refined from the previous one on a subsample
+* growth times larger. Once the center and radius move less than the tolerance between two
+* levels, the fit goes straight to the full point set for the final iterations
+*
+* @return true if a best fit circle is computable or else return false
+*
+*/
+bool Hierarchical_Fitter::compute_best_fit_circle() {
+	levels.clear();
+	if (points.size() < 3)
+		return false;
+	if (points.size() <= base_size)
+		return fit_level(points, true);
+
+	if (!fit_level(stratified_sample(base_size, 1), true))
+		return false;
+	for (size_t size = base_size * growth; size <= points.size() / growth; size *= growth) {
+		Fit_Level previous = levels.back();
+		if (!fit_level(stratified_sample(size, (unsigned int)levels.size() + 1), false))
+			return false;
+		double center_change = std::hypot(circle_center_est.x - previous.center.x, circle_center_est.y - previous.center.y);
+		if (center_change < tolerance && std::abs(radius_estimate - previous.radius) < tolerance)
+			break; // Parameters have stabilized
+	}
+	return fit_level(points, false);
+}
+
+/**
+* returns the circle's calculated radius
+*
+* @return radius_estimate Estimated radius
+*/
+double Hierarchical_Fitter::get_radius() {
+	return radius_estimate;
+}
+
+/**
+* returns the circle's calculated center coordinates
+*
+* @return circle_center_est Estimated center coordinates
+*/
+Circle_Center Hierarchical_Fitter::get_center_coordinate() {
+	return circle_center_est;
+}
+
+/**
+* returns the size, iterations, time and result of every level of the last fit
+*
+* @return levels Fitted levels from coarse to fine
+*/
+const std::vector<Fit_Level>& Hierarchical_Fitter::get_levels() {
+	return levels;
+}
@@ -0,0 +1,46 @@
+/*
+* @file Hierarchical_Fitter.h
+* @brief Header file for Hierarchical_Fitter which fits very large point sets coarse to fine. The
+* circle is first fitted on a small stratified subsample, then refined on progressively larger
+* subsamples, and refined on the full set only once the estimate has stabilized, so the early
+* iterations do not touch every point.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include <vector>
+
+#pragma once
+#ifndef HIERARCHICAL_FITTER
+#define HIERARCHICAL_FITTER
+
+struct Fit_Level {
+	size_t point_count;
+	int iterations;
+	double seconds;
+	Circle_Center center;
+	double radius;
+};
+
+class Hierarchical_Fitter
+{
+private:
+	const std::vector<cv::Point>& points;
+	double tolerance;
+	size_t base_size;
+	size_t growth;
+	double radius_estimate;
+	Circle_Center circle_center_est;
+	std::vector<Fit_Level> levels;
+
+	std::vector<cv::Point> stratified_sample(size_t, unsigned int);
+	bool fit_level(const std::vector<cv::Point>&, bool);
+public:
+
+	Hierarchical_Fitter(const std::vector<cv::Point>&, double tolerance = 1.0e-3, size_t base_size = 64, size_t growth = 8);
+	bool compute_best_fit_circle();
+	double get_radius();
+	Circle_Center get_center_coordinate();
+	const std::vector<Fit_Level>& get_levels();
+};
+#endif
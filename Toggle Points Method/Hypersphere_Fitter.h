@@ -0,0 +1,623 @@
+/*
+* @file Hypersphere_Fitter.h
+* @brief Header file for Hypersphere_Fitter, the fitting engine shared by best fit circles and best fit
+* spheres. It is templated on the dimension D of the points: D = 2 fits circles and is used by
+* Best_Fitting_Circle, D = 3 fits spheres to 3D scans.
+*
+* The steps are those of Best_Fitting_Circle generalized to D dimensions (MAISONOBE): the radius
+* estimate is the mean distance to the center, the cost is the sum of the squared residuals and the
+* center is refined with the POLAK and RIBI`ERE method, with a Newton step along each direction.
+* Every sweep accumulates into independent lanes, so the compiler can vectorize it across points.
+*
+* The engine reads its points through a point source, its second template parameter, so every
+* fitter runs the same iterations on its own storage: Point_Buffer copies the points into one
+* array per dimension, Point_View reads the caller's points in place, Weighted_Point_View
+* (Weighted_Refinement.h) adds a weight per point, Fixed_Points (Fixed_Size_Fitter.h) holds a
+* number of points known at compile time on the stack and Streaming_Fitter reads a point file one
+* chunk at a time. A point source has size(), and sweep(totals, body), which calls
+* body(p, weight, sums) with the D coordinates p of every point and returns false if the points
+* could not be read. get_point(i, p) is only needed by initial_estimate.
+*
+*/
+
+#include <opencv2/core.hpp>
+#include "Fit_Budget.h"
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#pragma once
+#ifndef HYPERSPHERE_FITTER
+#define HYPERSPHERE_FITTER
+
+struct Sphere_Center {
+	double x;
+	double y;
+	double z;
+};
+struct Sphere_Result {
+	Sphere_Center center;
+	double radius;
+	bool is_computable;
+};
+
+/**
+* Coordinate d of a 2D or 3D OpenCV point
+*/
+template <typename T>
+inline double get_point_coordinate(const cv::Point_<T>& point, int d) {
+	return (d == 0) ? point.x : point.y;
+}
+template <typename T>
+inline double get_point_coordinate(const cv::Point3_<T>& point, int d) {
+	return (d == 0) ? point.x : ((d == 1) ? point.y : point.z);
+}
+
+// Number of independent accumulators of a sweep
+const int sweep_lanes = 4;
+
+/**
+* Runs body(i, sums) for i = 0 .. count - 1 and adds the S sums it accumulates to totals. Consecutive
+* indices accumulate into different lanes so that the additions do not depend on each other
+*/
+template <int S, typename Body>
+inline void sweep_in_lanes(size_t count, double(&totals)[S], Body body) {
+	double partial[sweep_lanes][S] = {};
+	size_t i = 0;
+	for (; i + sweep_lanes <= count; i += sweep_lanes) {
+		for (int lane = 0; lane < sweep_lanes; ++lane) {
+			body(i + lane, partial[lane]);
+		}
+	}
+	for (; i < count; ++i) {
+		body(i, partial[0]);
+	}
+	for (int s = 0; s < S; ++s) {
+		for (int lane = 0; lane < sweep_lanes; ++lane) {
+			totals[s] += partial[lane][s];
+		}
+	}
+}
+
+/*
+* Point source holding its own copy of the points, in one array per dimension
+*/
+template <int D>
+class Point_Buffer
+{
+private:
+	std::vector<double> coordinates[D];
+public:
+
+	/**
+	* Constructor to copy the points into the structure of arrays buffer
+	*
+	* @param points 2D points for D = 2, 3D points for D = 3
+	*/
+	template <typename Point_Type>
+	explicit Point_Buffer(const std::vector<Point_Type>& points) {
+		for (int d = 0; d < D; ++d) {
+			coordinates[d].resize(points.size());
+		}
+		for (size_t i = 0; i < points.size(); ++i) {
+			for (int d = 0; d < D; ++d) {
+				coordinates[d][i] = get_point_coordinate(points[i], d);
+			}
+		}
+	}
+	size_t size() const {
+		return coordinates[0].size();
+	}
+	void get_point(size_t i, double* p) const {
+		for (int d = 0; d < D; ++d) {
+			p[d] = coordinates[d][i];
+		}
+	}
+	template <int S, typename Body>
+	bool sweep(double(&totals)[S], Body body) const {
+		sweep_in_lanes(size(), totals, [&](size_t i, double* sums) {
+			double p[D];
+			get_point(i, p);
+			body(p, 1.0, sums);
+		});
+		return true;
+	}
+};
+
+/*
+* Point source reading the caller's points in place. The points are not copied and must outlive
+* the fitter
+*/
+template <int D, typename Point_Type>
+class Point_View
+{
+private:
+	const Point_Type* points;
+	size_t count;
+public:
+
+	/**
+	* Constructor to refer to the caller's points
+	*
+	* @param points 2D points for D = 2, 3D points for D = 3
+	*/
+	explicit Point_View(const std::vector<Point_Type>& points) {
+		this->points = points.data();
+		this->count = points.size();
+	}
+	size_t size() const {
+		return count;
+	}
+	void get_point(size_t i, double* p) const {
+		for (int d = 0; d < D; ++d) {
+			p[d] = get_point_coordinate(points[i], d);
+		}
+	}
+	template <int S, typename Body>
+	bool sweep(double(&totals)[S], Body body) const {
+		sweep_in_lanes(count, totals, [&](size_t i, double* sums) {
+			double p[D];
+			get_point(i, p);
+			body(p, 1.0, sums);
+		});
+		return true;
+	}
+};
+
+template <int D, typename Points = Point_Buffer<D>>
+class Hypersphere_Fitter
+{
+public:
+	typedef std::array<double, D> Vector;
+private:
+	Points points;
+	Vector center_est;
+	double radius_estimate;
+	double cost;
+	Vector gradient_est; // Cost gradient at center_est, from the same sweep as the cost
+	double total_weight; // Number of points, or the sum of their weights
+	int iteration_count;
+	double step_tolerance = 0.0;
+	Fit_Budget budget;
+	Fit_Deadline deadline;
+	Fit_Stop stop_reason = stopped_not_converged;
+	size_t points_swept = 0;
+	int sweep_count = 0;
+	bool is_source_failed = false; // A sweep could not read the points
+
+	/**
+	* Sweeps the points once with body(p, weight, sums) and adds up the S sums it accumulates. If
+	* the point source fails the sums are NaN, so the step is rejected, and the fit stops as failed
+	*/
+	template <int S, typename Body>
+	void sweep(double(&totals)[S], Body body) {
+		for (int s = 0; s < S; ++s) {
+			totals[s] = 0.0;
+		}
+		if (!points.sweep(totals, body))
+		{
+			is_source_failed = true;
+			for (int s = 0; s < S; ++s) {
+				totals[s] = std::numeric_limits<double>::quiet_NaN();
+			}
+		}
+		points_swept += points.size();
+		++sweep_count;
+	}
+
+	/**
+	* Offset from point p to a center and its length
+	*/
+	static inline double get_offset(const double* p, const Vector& center, double* offset) {
+		double squared = 0.0;
+		for (int d = 0; d < D; ++d) {
+			offset[d] = center[d] - p[d];
+			squared += offset[d] * offset[d];
+		}
+		return sqrt(squared);
+	}
+
+	/**
+	* Checks the budget before a line search step. The cost never increases, so the current center
+	* is always the best one found so far
+	*
+	* @return true if the fit has to stop, with the reason in stop_reason
+	*/
+	bool budget_exhausted() {
+		if (is_source_failed)
+			stop_reason = stopped_failed;
+		else if (budget.target_rms > 0 && cost <= budget.target_rms * budget.target_rms * total_weight)
+			stop_reason = stopped_target_rms;
+		else if (budget.max_iterations > 0 && iteration_count >= budget.max_iterations)
+			stop_reason = stopped_iteration_budget;
+		else if (deadline.has_expired(points_swept))
+			stop_reason = stopped_deadline;
+		else
+			return false;
+		return true;
+	}
+
+	/**
+	* Solves the n x n system a x = b in place with Gaussian elimination and partial pivoting
+	*/
+	static bool solve_linear(double(&a)[D + 1][D + 1], double(&b)[D + 1]) {
+		for (int col = 0; col <= D; ++col) {
+			int pivot = col;
+			for (int row = col + 1; row <= D; ++row) {
+				if (std::abs(a[row][col]) > std::abs(a[pivot][col]))
+					pivot = row;
+			}
+			if (std::abs(a[pivot][col]) < 1.0e-12 * std::abs(a[0][0]) || a[pivot][col] == 0)
+				return false;
+			std::swap(a[pivot], a[col]);
+			std::swap(b[pivot], b[col]);
+			for (int row = col + 1; row <= D; ++row) {
+				double factor = a[row][col] / a[col][col];
+				for (int k = col; k <= D; ++k) {
+					a[row][k] -= factor * a[col][k];
+				}
+				b[row] -= factor * b[col];
+			}
+		}
+		for (int row = D; row >= 0; --row) {
+			for (int k = row + 1; k <= D; ++k) {
+				b[row] -= a[row][k] * b[k];
+			}
+			b[row] /= a[row][row];
+		}
+		return true;
+	}
+public:
+
+	/**
+	* Constructor to setup the point source
+	*
+	* @param sources Arguments of the point source's constructor, such as the points of a
+	* Point_Buffer or Point_View
+	*
+	*/
+	template <typename... Sources>
+	explicit Hypersphere_Fitter(const Sources&... sources) : points(sources...) {
+		center_est.fill(0.0);
+		gradient_est.fill(0.0);
+		radius_estimate = 0.0;
+		cost = 0.0;
+		total_weight = (double)points.size();
+		iteration_count = 0;
+	}
+
+	/**
+	* Estimates the center with an algebraic fit: the weighted sum of (|p|^2 + a . p + c)^2 is
+	* minimized by a linear system, so one sweep over the points is enough. Coordinates are taken
+	* relative to the first point to keep the squared terms small
+	*
+	* @return true if the points span all D dimensions
+	*/
+	bool initial_estimate() {
+		if (points.size() < D + 1)
+			return false;
+		double origin[D];
+		points.get_point(0, origin);
+		// Sums of p p^T, p, |p|^2 p, |p|^2 and the weights over the shifted points
+		const int sum_count = D * D + 2 * D + 2;
+		double sums[sum_count];
+		sweep(sums, [&](const double* point, double weight, double* accumulator) {
+			double p[D];
+			double z = 0.0;
+			for (int d = 0; d < D; ++d) {
+				p[d] = point[d] - origin[d];
+				z += p[d] * p[d];
+			}
+			for (int r = 0; r < D; ++r) {
+				for (int c = 0; c < D; ++c) {
+					accumulator[r * D + c] += weight * p[r] * p[c];
+				}
+				accumulator[D * D + r] += weight * p[r];
+				accumulator[D * D + D + r] += weight * z * p[r];
+			}
+			accumulator[D * D + 2 * D] += weight * z;
+			accumulator[D * D + 2 * D + 1] += weight;
+		});
+		double a[D + 1][D + 1];
+		double b[D + 1];
+		for (int r = 0; r < D; ++r) {
+			for (int c = 0; c < D; ++c) {
+				a[r][c] = sums[r * D + c];
+			}
+			a[r][D] = sums[D * D + r];
+			a[D][r] = sums[D * D + r];
+			b[r] = -sums[D * D + D + r];
+		}
+		a[D][D] = sums[D * D + 2 * D + 1];
+		b[D] = -sums[D * D + 2 * D];
+		if (!solve_linear(a, b))
+			return false; // The points lie in a lower dimensional subspace
+		for (int d = 0; d < D; ++d) {
+			center_est[d] = origin[d] - b[d] / 2;
+		}
+		return true;
+	}
+
+	/**
+	* Determine the radius estimate, the cost and the cost gradient at the current center in one
+	* sweep. The squared residuals are accumulated around the previous radius estimate, which is
+	* close to the new one, so the cost keeps its precision when it is much smaller than the squared
+	* radius. The gradient 2 sum (c - p) (d - r) / d is split the same way, into the sums around the
+	* previous radius and the sums of (c - p) / d that the change of radius multiplies
+	*
+	* @return cost Cost value
+	*/
+	double compute_radius_and_cost() {
+		double reference_radius = radius_estimate;
+		const Vector center = center_est;
+		double sums[3 + 2 * D];
+		sweep(sums, [&](const double* p, double weight, double* accumulator) {
+			double offset[D];
+			double distance = get_offset(p, center, offset);
+			double inverse_distance = (distance > 0) ? 1.0 / distance : 0.0;
+			double e = distance - reference_radius;
+			accumulator[0] += weight * e;
+			accumulator[1] += weight * e * e;
+			accumulator[2] += weight;
+			for (int d = 0; d < D; ++d) {
+				double direction = weight * offset[d] * inverse_distance;
+				accumulator[3 + d] += direction * e;
+				accumulator[3 + D + d] += direction;
+			}
+		});
+		total_weight = sums[2];
+		double mean_residual = sums[0] / total_weight;
+		radius_estimate = reference_radius + mean_residual;
+		cost = std::max(0.0, sums[1] - total_weight * mean_residual * mean_residual);
+		for (int d = 0; d < D; ++d) {
+			gradient_est[d] = 2 * (sums[3 + d] - mean_residual * sums[3 + D + d]);
+		}
+		if (!std::isfinite(radius_estimate) || !std::isfinite(sums[1]))
+			cost = std::numeric_limits<double>::infinity(); // A center far off the points overflows, so a step there never lowers the cost
+		return cost;
+	}
+
+	/**
+	* returns the cost gradient at the current center, computed by compute_radius_and_cost
+	*
+	* @return cost_gradient Cost gradient for each coordinate
+	*/
+	Vector get_gradient_for_conjugate_gradient() {
+		return gradient_est;
+	}
+
+	/**
+	* Computes the lambda value by performing the Newton solver on the derivative
+	* of the cost function along a direction
+	*
+	* @param u Directional gradient
+	* @return lambda updated lambda value
+	*/
+	double compute_lambda(const Vector& u) {
+		const Vector center = center_est;
+		const double radius = radius_estimate;
+		double sums[4];
+		sweep(sums, [&](const double* p, double weight, double* accumulator) {
+			double offset[D];
+			double distance = get_offset(p, center, offset);
+			double inverse_distance = (distance > 0) ? 1.0 / distance : 0.0;
+			double c1 = 0.0;
+			for (int d = 0; d < D; ++d) {
+				c1 += offset[d] * u[d];
+			}
+			c1 *= inverse_distance;
+			double c2 = distance - radius;
+			accumulator[0] += weight * c1 * c2;
+			accumulator[1] += weight * c2 * inverse_distance;
+			accumulator[2] += weight * c1;
+			accumulator[3] += weight * c1 * c1 * inverse_distance;
+		});
+		double u_squared = 0.0;
+		for (int d = 0; d < D; ++d) {
+			u_squared += u[d] * u[d];
+		}
+		// Where the cost is not convex along u the curvature is negative, its magnitude is used so the step still goes downhill
+		return -sums[0] / std::abs(u_squared * sums[1] - sums[2] * sums[2] / total_weight + radius * sums[3]);
+	}
+
+	/**
+	* Computes the conjugate gradient by using POLAK and RIBI`ERE method to determine if the
+	* algorithm can converge within a set of iterations to find the best possible fit
+	*
+	* @param cost_gradient Cost gradient at the current center
+	* @return the state of convergence
+	*/
+	bool converge(Vector cost_gradient) {
+		double gradient_norm = 0.0;
+		for (int d = 0; d < D; ++d) {
+			gradient_norm += cost_gradient[d] * cost_gradient[d];
+		}
+		if (cost < 1.0e-10 || sqrt(gradient_norm) < 1.0e-10)
+			return true; //found out minimum solution
+
+		Vector previous_cost_gradient = cost_gradient;
+		Vector u_prev;
+		u_prev.fill(0.0);
+		for (int i = 0; i < 100; i++) {
+			Vector u;
+			for (int d = 0; d < D; ++d) {
+				u[d] = -1 * cost_gradient[d];
+			}
+			if (i > 0) {
+				double numerator = 0.0, denominator = 0.0;
+				for (int d = 0; d < D; ++d) {
+					numerator += cost_gradient[d] * (cost_gradient[d] - previous_cost_gradient[d]);
+					denominator += previous_cost_gradient[d] * previous_cost_gradient[d];
+				}
+				double beta = numerator / denominator;
+				for (int d = 0; d < D; ++d) {
+					u[d] += beta * u_prev[d];
+				}
+			}
+			previous_cost_gradient = cost_gradient;
+			u_prev = u;
+			double u_norm = 0.0;
+			for (int d = 0; d < D; ++d) {
+				u_norm += u[d] * u[d];
+			}
+			u_norm = sqrt(u_norm);
+			double scale = radius_estimate;
+			for (int d = 0; d < D; ++d) {
+				scale += std::abs(center_est[d]);
+			}
+			double iteration_start_cost = cost;
+			Vector iteration_start_center = center_est;
+			double previous_cost;
+			double step_length;
+			int j = 0;
+
+			do {
+				if (budget_exhausted())
+					return stop_reason == stopped_target_rms;
+				previous_cost = cost;
+				double previous_radius = radius_estimate;
+				Vector previous_gradient = gradient_est;
+				double lambda = compute_lambda(u);
+				step_length = std::abs(lambda) * u_norm;
+				if (step_length < step_tolerance || step_length < 1.0e-10 * scale)
+					break; // Step is below the tolerance or too small for the cost to resolve, no need to evaluate it
+				Vector step_start = center_est;
+				// The Newton step can overshoot far from the points, so halve it until the cost decreases
+				for (int halving = 0; halving < 30 && std::abs(lambda) * u_norm >= 1.0e-10 * scale; ++halving, lambda /= 2) {
+					for (int d = 0; d < D; ++d) {
+						center_est[d] = step_start[d] + lambda * u[d];
+					}
+					radius_estimate = previous_radius;
+					compute_radius_and_cost();
+					if (cost <= previous_cost || deadline.has_expired(points_swept))
+						break;
+				}
+				if (!(cost <= previous_cost))
+				{
+					// No decrease along this direction
+					center_est = step_start;
+					radius_estimate = previous_radius;
+					cost = previous_cost;
+					gradient_est = previous_gradient;
+				}
+				step_length = 0.0;
+				for (int d = 0; d < D; ++d) {
+					step_length += (center_est[d] - step_start[d]) * (center_est[d] - step_start[d]);
+				}
+				step_length = sqrt(step_length);
+				++iteration_count;
+			} while (++j < 10 && std::abs(cost - previous_cost) / cost > 1.0e-10 && step_length >= step_tolerance);
+			if (cost < 1.0e-10 || (iteration_start_cost - cost) / cost < 1.0e-12)
+				return true; // The whole line search no longer reduces the cost
+			double moved = 0.0;
+			for (int d = 0; d < D; ++d) {
+				moved += (center_est[d] - iteration_start_center[d]) * (center_est[d] - iteration_start_center[d]);
+			}
+			if (sqrt(moved) < step_tolerance)
+				return true; // The center moved less than the caller's tolerance
+			cost_gradient = get_gradient_for_conjugate_gradient();
+			gradient_norm = 0.0;
+			for (int d = 0; d < D; ++d) {
+				gradient_norm += cost_gradient[d] * cost_gradient[d];
+			}
+			if (sqrt(gradient_norm) < 1.0e-10)
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	* Refines a given estimate of the center without running the initializer
+	*
+	* @param center_estimate Starting estimate of the center
+	* @param known_radius Radius at the starting center if known, which saves a sweep, 0 otherwise
+	* @return true if the fit converged
+	*/
+	bool refine_best_fit_sphere(const Vector& center_estimate, double known_radius = 0.0) {
+		if (points.size() == 0)
+			return false;
+		is_source_failed = false;
+		center_est = center_estimate;
+		radius_estimate = known_radius;
+		compute_radius_and_cost();
+		if (!(known_radius > 0))
+		{
+			if (deadline.has_expired(points_swept))
+			{
+				// Out of time already, the starting center and its radius are the best circle found
+				stop_reason = stopped_deadline;
+				return false;
+			}
+			compute_radius_and_cost(); // Second sweep around the first radius estimate for an accurate cost
+		}
+		stop_reason = stopped_not_converged;
+		bool convergence = std::isfinite(cost) && converge(gradient_est);
+		bool is_finite = std::isfinite(cost) && std::isfinite(radius_estimate);
+		for (int d = 0; d < D; ++d) {
+			is_finite = is_finite && std::isfinite(center_est[d]);
+		}
+		if (is_source_failed || !is_finite)
+		{
+			// The points could not be read, or the starting center was too far off them for the cost to be evaluated
+			stop_reason = stopped_failed;
+			return false;
+		}
+		if (stop_reason == stopped_not_converged && convergence)
+			stop_reason = stopped_converged;
+		return convergence;
+	}
+
+	/**
+	* Fits the circle or sphere from the algebraic initial estimate
+	*
+	* @return true if the fit converged
+	*/
+	bool compute_best_fit_sphere() {
+		if (!initial_estimate())
+			return false;
+		return refine_best_fit_sphere(center_est);
+	}
+
+	double get_radius() {
+		return radius_estimate;
+	}
+	Vector get_center() {
+		return center_est;
+	}
+	double get_cost() {
+		return cost;
+	}
+	int get_iteration_count() {
+		return iteration_count;
+	}
+	size_t get_point_count() {
+		return points.size();
+	}
+	int get_sweep_count() {
+		return sweep_count;
+	}
+	const Points& get_points() {
+		return points;
+	}
+	void set_step_tolerance(double step_tolerance) {
+		this->step_tolerance = step_tolerance;
+	}
+
+	/**
+	* Limits the following fits by a time budget, an iteration budget and a target RMS residual.
+	* A fit that runs out of budget keeps the best center found so far
+	*
+	* @param budget Limits of the fit
+	* @param start Time the budget started, for example when the caller received the points
+	*/
+	void set_budget(const Fit_Budget& budget, std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now()) {
+		this->budget = budget;
+		deadline = Fit_Deadline(budget.time_budget, start);
+	}
+	Fit_Stop get_stop_reason() {
+		return stop_reason;
+	}
+};
+#endif
@@ -0,0 +1,53 @@
+/*
+* @file Mouse_State.cpp
+* @brief Source file for Mouse_State, the left button state machine shared by both interactive front
+* ends. It turns the stream of mouse events into one press and one release per click.
+*
+*/
+#include "Mouse_State.h"
+
+/**
+* Records a mouse event and reports whether it completed a press or a release of the left button.
+* The button starts out released, so the first event reports a release
+*
+* @param event Mouse event
+* @return transition button_pressed or button_released once per change of the button, or no_transition
+*
+*/
+Mouse_Transition Mouse_State::update(Mouse_Event event) {
+	if (event == mouse_button_down)
+	{
+		// Recognize user's mouse click and set appropriate flags
+		left_button_clicked = true;
+		left_button_released = false;
+	}
+	if (event == mouse_button_up)
+	{
+		// Recognize user's mouse release and set appropriate flags
+		left_button_released = true;
+		left_button_clicked = false;
+	}
+
+	if (left_button_clicked && clicked_flag)
+	{
+		clicked_flag = false;
+		released_flag = true;
+		return button_pressed;
+	}
+	if (left_button_released && released_flag)
+	{
+		released_flag = false;
+		clicked_flag = true;
+		return button_released;
+	}
+	return no_transition;
+}
+
+/**
+* returns the state of the left button
+*
+* @return true if the left button is up
+*/
+bool Mouse_State::is_button_released() const {
+	return left_button_released;
+}
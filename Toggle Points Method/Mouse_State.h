@@ -0,0 +1,38 @@
+/*
+* @file Mouse_State.h
+* @brief Header file for Mouse_State, the left button state machine shared by both interactive front
+* ends. It turns the stream of mouse events into one press and one release per click. The front end
+* translates the events of its window toolkit into Mouse_Event values, so no GUI library is needed here.
+*
+*/
+
+#pragma once
+#ifndef MOUSE_STATE
+#define MOUSE_STATE
+
+enum Mouse_Event {
+	mouse_moved,
+	mouse_button_down,
+	mouse_button_up
+};
+
+enum Mouse_Transition {
+	no_transition,
+	button_pressed,
+	button_released
+};
+
+class Mouse_State
+{
+private:
+	// Parameters to check for mouse activity
+	bool left_button_clicked = false;
+	bool left_button_released = true;
+	bool clicked_flag = true;
+	bool released_flag = true;
+public:
+
+	Mouse_Transition update(Mouse_Event);
+	bool is_button_released() const;
+};
+#endif
@@ -0,0 +1,40 @@
+/*
+* @file Parallel_Blocks.h
+* @brief Splits a sweep over a point buffer into contiguous blocks, one per worker thread. Used by the
+* fitters that keep their points in structure of arrays buffers and reduce per block partial sums.
+*
+*/
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#pragma once
+#ifndef PARALLEL_BLOCKS
+#define PARALLEL_BLOCKS
+
+// Sweeps shorter than this run on the calling thread only
+const size_t min_points_per_thread = 32768;
+
+/**
+* Splits [0, count) into one contiguous block per thread and runs body(begin, end, block) on each
+*
+* @param count Number of points
+* @param thread_count Maximum number of threads
+* @param body Function processing one block
+* @return blocks Number of blocks used
+*/
+template <typename Body>
+inline unsigned int parallel_blocks(size_t count, unsigned int thread_count, Body body) {
+	unsigned int blocks = (unsigned int)std::max<size_t>(1, std::min<size_t>(thread_count, count / min_points_per_thread));
+	std::vector<std::thread> threads;
+	for (unsigned int b = 1; b < blocks; ++b) {
+		threads.emplace_back(body, count * b / blocks, count * (b + 1) / blocks, b);
+	}
+	body(0, count / blocks, 0);
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	return blocks;
+}
+#endif
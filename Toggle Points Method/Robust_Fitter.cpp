@@ -0,0 +1,201 @@
+/*
+* @file Robust_Fitter.cpp
+* @brief Source file for Robust_Fitter which fits a best fit circle with iteratively reweighted
+* least squares and a Huber or Tukey M-estimator.
+*
+*/
+#include "Robust_Fitter.h"
+#include "Algebraic_Fit.h"
+#include "Parallel_Blocks.h"
+#include <algorithm>
+#include <thread>
+
+/**
+* Constructor to copy the points into the structure of arrays buffer
+*
+* @param points Points list selected by the user
+* @param estimator M-estimator used to weight the points
+* @param thread_count Number of worker threads, 0 uses every available core
+*
+*/
+Robust_Fitter::Robust_Fitter(const std::vector<cv::Point>& points, M_Estimator estimator, unsigned int thread_count) {
+	xs.resize(points.size());
+	ys.resize(points.size());
+	for (size_t i = 0; i < points.size(); ++i) {
+		xs[i] = points[i].x;
+		ys[i] = points[i].y;
+	}
+	residuals.assign(points.size(), 0.0);
+	weights.assign(points.size(), 1.0);
+	this->estimator = estimator;
+	if (thread_count == 0)
+		thread_count = std::thread::hardware_concurrency();
+	this->thread_count = (thread_count > 0) ? thread_count : 1;
+	this->circle_center_est.x = 0.0;
+	this->circle_center_est.y = 0.0;
+	this->radius_estimate = 0.0;
+	this->cost = 0.0;
+	this->scale = 0.0;
+	this->irls_iterations = 0;
+	this->pass_count = 0;
+}
+
+/**
+* Refines the circle with the current weights using the POLAK and RIBI`ERE method of
+* Hypersphere_Fitter, for at most the given number of line search steps
+*
+* @param max_steps Maximum number of steps
+*/
+void Robust_Fitter::refine(int max_steps) {
+	Weighted_Point_View points(xs.data(), ys.data(), weights.data(), xs.size(), thread_count);
+	refine_weighted(points, circle_center_est, radius_estimate, cost, max_steps, 0.0, &pass_count);
+}
+
+/**
+* Recomputes the residual and weight of every point. The scale is the median absolute
+* residual, scaled to match the standard deviation of Gaussian noise
+*
+* @param weight_function M-estimator used for this update
+*/
+void Robust_Fitter::update_weights(M_Estimator weight_function) {
+	const double* x = xs.data();
+	const double* y = ys.data();
+	double* e = residuals.data();
+	double* a = scratch.data();
+	Circle_Center center = circle_center_est;
+	double radius = radius_estimate;
+	parallel_blocks(xs.size(), thread_count, [&](size_t begin, size_t end, unsigned int) {
+		for (size_t i = begin; i < end; ++i) {
+			e[i] = sqrt((x[i] - center.x) * (x[i] - center.x) + (y[i] - center.y) * (y[i] - center.y)) - radius;
+			a[i] = std::abs(e[i]);
+		}
+	});
+	std::nth_element(scratch.begin(), scratch.begin() + scratch.size() / 2, scratch.end());
+	scale = 1.4826 * scratch[scratch.size() / 2];
+	scale = std::max(scale, 1.0e-9 * (1.0 + radius)); // All the points on the circle
+
+	double* w = weights.data();
+	if (weight_function == huber)
+	{
+		double k = 1.345 * scale;
+		parallel_blocks(xs.size(), thread_count, [&](size_t begin, size_t end, unsigned int) {
+			for (size_t i = begin; i < end; ++i) {
+				double r = std::abs(e[i]);
+				w[i] = (r <= k) ? 1.0 : k / r;
+			}
+		});
+	}
+	else if (weight_function == tukey)
+	{
+		double c = 4.685 * scale;
+		parallel_blocks(xs.size(), thread_count, [&](size_t begin, size_t end, unsigned int) {
+			for (size_t i = begin; i < end; ++i) {
+				double t = e[i] / c;
+				double s = 1.0 - t * t;
+				w[i] = (s > 0) ? s * s : 0.0;
+			}
+		});
+	}
+}
+
+/**
+* Fits the circle. The algebraic estimate is refined into the ordinary least squares circle,
+* then the weights and the circle are updated in turn until the circle stops moving. The Tukey
+* estimator rejects points completely, so it starts from a few Huber iterations to avoid
+* locking onto a wrong circle
+*
+* @return true if a best fit circle is computable or else return false
+*
+*/
+bool Robust_Fitter::compute_best_fit_circle() {
+	irls_iterations = 0;
+	pass_count = 0;
+	std::fill(weights.begin(), weights.end(), 1.0);
+	scratch.resize(xs.size());
+
+	// Algebraic estimate, accumulated per thread and merged
+	std::vector<Algebraic_Fit> partial(thread_count);
+	unsigned int blocks = parallel_blocks(xs.size(), thread_count, [&](size_t begin, size_t end, unsigned int block) {
+		for (size_t i = begin; i < end; ++i) {
+			partial[block].add(xs[i], ys[i]);
+		}
+	});
+	for (unsigned int b = 1; b < blocks; ++b) {
+		partial[0].merge(partial[b]);
+	}
+	++pass_count;
+	if (!partial[0].solve(circle_center_est, radius_estimate))
+		return false;
+
+	refine(20);
+	if (estimator == least_squares)
+		return true;
+
+	for (; irls_iterations < 50; ++irls_iterations) {
+		Circle_Center previous_center = circle_center_est;
+		double previous_radius = radius_estimate;
+		update_weights((estimator == tukey && irls_iterations < 3) ? huber : estimator);
+		refine(5);
+		double change = sqrt(pow(circle_center_est.x - previous_center.x, 2) + pow(circle_center_est.y - previous_center.y, 2))
+			+ std::abs(radius_estimate - previous_radius);
+		if (irls_iterations >= 3 && change < 1.0e-6 * (1.0 + radius_estimate))
+			break;
+	}
+	update_weights(estimator); // Weights and residuals of the final circle
+	return true;
+}
+
+/**
+* returns the circle's calculated radius
+*
+* @return radius_estimate Estimated radius
+*/
+double Robust_Fitter::get_radius() {
+	return radius_estimate;
+}
+
+/**
+* returns the circle's calculated center coordinates
+*
+* @return circle_center_est Estimated center coordinates
+*/
+Circle_Center Robust_Fitter::get_center_coordinate() {
+	return circle_center_est;
+}
+
+/**
+* returns the robust scale of the residuals of the fitted circle
+*
+* @return scale Median absolute residual scaled to a standard deviation
+*/
+double Robust_Fitter::get_scale() {
+	return scale;
+}
+
+/**
+* returns the final weight of every point, in the order the points were given. Outliers get a
+* low weight, or zero with the Tukey estimator
+*
+* @return weights Per point weights
+*/
+const std::vector<double>& Robust_Fitter::get_weights() {
+	return weights;
+}
+
+/**
+* returns the number of reweighting iterations of the last fit
+*
+* @return irls_iterations Iteration count
+*/
+int Robust_Fitter::get_irls_iterations() {
+	return irls_iterations;
+}
+
+/**
+* returns the number of sweeps over the points of the last fit
+*
+* @return pass_count Sweep count
+*/
+int Robust_Fitter::get_pass_count() {
+	return pass_count;
+}
@@ -0,0 +1,59 @@
+/*
+* @file Robust_Fitter.h
+* @brief Header file for Robust_Fitter which fits a best fit circle that is not pulled by
+* misclicked or outlying points. It uses iteratively reweighted least squares: each iteration
+* fits the circle with per point weights and then lowers the weight of points far from it with
+* a Huber or Tukey M-estimator, using a robust (median absolute deviation) scale.
+*
+* Coordinates, residuals and weights are stored as separate arrays so that the per point loops
+* are simple strided sweeps, and every sweep is split over the worker threads.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include "Weighted_Refinement.h"
+#include <vector>
+
+#pragma once
+#ifndef ROBUST_FITTER
+#define ROBUST_FITTER
+
+enum M_Estimator {
+	least_squares,
+	huber,
+	tukey
+};
+
+class Robust_Fitter
+{
+private:
+	// Point buffer in structure of arrays layout
+	std::vector<double> xs;
+	std::vector<double> ys;
+	std::vector<double> residuals;
+	std::vector<double> weights;
+	std::vector<double> scratch; // Absolute residuals for the median
+
+	M_Estimator estimator;
+	unsigned int thread_count;
+	double radius_estimate;
+	Circle_Center circle_center_est;
+	double cost;
+	double scale;
+	int irls_iterations;
+	int pass_count;
+
+	void refine(int);
+	void update_weights(M_Estimator);
+public:
+
+	Robust_Fitter(const std::vector<cv::Point>&, M_Estimator estimator = tukey, unsigned int thread_count = 0);
+	bool compute_best_fit_circle();
+	double get_radius();
+	Circle_Center get_center_coordinate();
+	double get_scale();
+	const std::vector<double>& get_weights();
+	int get_irls_iterations();
+	int get_pass_count();
+};
+#endif
@@ -0,0 +1,203 @@
+/*
+* @file Streaming_Fitter.cpp
+* @brief Source file for Streaming_Fitter which fits a best fit circle to a point file larger than
+* the available memory with bounded, double buffered chunked reads.
+*
+*/
+#include "Streaming_Fitter.h"
+#include "Algebraic_Fit.h"
+#include "Hypersphere_Fitter.h"
+#include <chrono>
+#include <future>
+#include <utility>
+
+static_assert(sizeof(cv::Point) == 2 * sizeof(int32_t), "cv::Point must match the point file layout");
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+* Constructor to setup the point file and the chunk size
+*
+* @param path Path of the point file of int32 (x, y) pairs
+* @param chunk_points Number of points per chunk, two chunks are held in memory
+* @param step_tolerance Refinement stops once a step would move the center less than this
+*
+*/
+Streaming_Fitter::Streaming_Fitter(const std::string& path, size_t chunk_points, double step_tolerance) {
+	this->path = path;
+	this->chunk_points = (chunk_points > 0) ? chunk_points : 1;
+	this->step_tolerance = step_tolerance;
+	this->circle_center_est.x = 0.0;
+	this->circle_center_est.y = 0.0;
+	this->radius_estimate = 0.0;
+	this->cost = 0.0;
+	this->stats = Streaming_Stats();
+}
+
+/**
+* Streams the whole file through the processing function. While one buffer is processed the next
+* chunk is read into the other buffer on a separate thread
+*
+* @param process Function called with each chunk of points in file order
+* @return false if the file cannot be opened, a read fails or the file ends in a partial point
+*
+*/
+bool Streaming_Fitter::stream_pass(const std::function<void(const cv::Point*, size_t)>& process) {
+	std::FILE* file = std::fopen(path.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+	std::vector<cv::Point> buffers[2];
+	buffers[0].resize(chunk_points);
+	buffers[1].resize(chunk_points);
+
+	// Reads the next chunk and returns the number of bytes read and the time it took. Bytes rather
+	// than points, so that a file ending in part of a point is seen instead of silently dropped
+	auto read_chunk = [this, file](std::vector<cv::Point>* buffer) {
+		Clock::time_point start = Clock::now();
+		size_t bytes = std::fread(buffer->data(), 1, chunk_points * sizeof(cv::Point), file);
+		return std::make_pair(bytes, std::chrono::duration<double>(Clock::now() - start).count());
+	};
+
+	std::future<std::pair<size_t, double>> pending = std::async(std::launch::async, read_chunk, &buffers[0]);
+	int current = 0;
+	while (true) {
+		Clock::time_point wait_start = Clock::now();
+		std::pair<size_t, double> chunk = pending.get();
+		stats.stall_seconds += std::chrono::duration<double>(Clock::now() - wait_start).count();
+		stats.io_seconds += chunk.second;
+		stats.bytes_read += chunk.first;
+		size_t count = chunk.first / sizeof(cv::Point);
+		bool is_last_chunk = count < chunk_points;
+		if (is_last_chunk && (std::ferror(file) || chunk.first % sizeof(cv::Point) != 0))
+		{
+			// A short read is only the end of the file if the stream has no error and the file
+			// holds whole points, a trailing partial point means a truncated or mismatched file
+			std::fclose(file);
+			return false;
+		}
+		if (count == 0)
+			break;
+
+		// Start reading the next chunk before processing this one
+		if (!is_last_chunk)
+			pending = std::async(std::launch::async, read_chunk, &buffers[1 - current]);
+
+		Clock::time_point compute_start = Clock::now();
+		process(buffers[current].data(), count);
+		stats.compute_seconds += std::chrono::duration<double>(Clock::now() - compute_start).count();
+		current = 1 - current;
+		if (is_last_chunk)
+			break;
+	}
+	std::fclose(file);
+	++stats.passes;
+	return true;
+}
+
+/**
+* Computes the initial estimate in a single pass with an algebraic least squares fit, which
+* only needs sums of powers of the coordinates
+*
+* @return true if the points are not all aligned
+*
+*/
+bool Streaming_Fitter::initial_estimate() {
+	Algebraic_Fit algebraic_fit;
+	bool streamed = stream_pass([&](const cv::Point* points, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			algebraic_fit.add(points[i].x, points[i].y);
+		}
+	});
+	stats.points = (unsigned long long)algebraic_fit.get_count();
+	return streamed && algebraic_fit.solve(circle_center_est, radius_estimate);
+}
+
+/*
+* Point source of Hypersphere_Fitter streaming the point file, every sweep is one pass over the file
+*/
+class Streamed_Points
+{
+private:
+	Streaming_Fitter* fitter;
+public:
+	explicit Streamed_Points(Streaming_Fitter* fitter) {
+		this->fitter = fitter;
+	}
+	size_t size() const {
+		return (size_t)fitter->stats.points;
+	}
+	template <int S, typename Body>
+	bool sweep(double(&totals)[S], Body body) const {
+		return fitter->stream_pass([&](const cv::Point* points, size_t count) {
+			sweep_in_lanes(count, totals, [&](size_t i, double* sums) {
+				double p[2] = { (double)points[i].x, (double)points[i].y };
+				body(p, 1.0, sums);
+			});
+		});
+	}
+};
+
+/**
+* Fits the circle to the point file. The algebraic estimate is refined with the POLAK and
+* RIBI`ERE method of Hypersphere_Fitter until a step would move the center less than the step
+* tolerance or the cost stops decreasing
+*
+* @return true if a best fit circle is computable or else return false
+*
+*/
+bool Streaming_Fitter::compute_best_fit_circle() {
+	stats = Streaming_Stats();
+	Clock::time_point start = Clock::now();
+	bool convergence = false;
+	if (initial_estimate())
+	{
+		Hypersphere_Fitter<2, Streamed_Points> engine(this);
+		Fit_Budget budget;
+		budget.max_iterations = 100;
+		engine.set_budget(budget);
+		engine.set_step_tolerance(step_tolerance);
+		convergence = engine.refine_best_fit_sphere({ circle_center_est.x, circle_center_est.y }, radius_estimate);
+		circle_center_est.x = engine.get_center()[0];
+		circle_center_est.y = engine.get_center()[1];
+		radius_estimate = engine.get_radius();
+		cost = engine.get_cost();
+	}
+	stats.wall_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	return convergence;
+}
+
+/**
+* returns the circle's calculated radius
+*
+* @return radius_estimate Estimated radius
+*/
+double Streaming_Fitter::get_radius() {
+	return radius_estimate;
+}
+
+/**
+* returns the circle's calculated center coordinates
+*
+* @return circle_center_est Estimated center coordinates
+*/
+Circle_Center Streaming_Fitter::get_center_coordinate() {
+	return circle_center_est;
+}
+
+/**
+* returns the least squares cost of the fitted circle
+*
+* @return cost Sum of squared distances between the points and the circle
+*/
+double Streaming_Fitter::get_cost() {
+	return cost;
+}
+
+/**
+* returns the pass, I/O and compute statistics of the last fit
+*
+* @return stats Streaming statistics
+*/
+Streaming_Stats Streaming_Fitter::get_stats() {
+	return stats;
+}
@@ -0,0 +1,62 @@
+/*
+* @file Streaming_Fitter.h
+* @brief Header file for Streaming_Fitter which fits a best fit circle to a point file larger than
+* the available memory. The file holds int32 (x, y) pairs, the same layout as the fitting daemon's
+* requests. Points are read in fixed size chunks into two buffers, so the next chunk is read while
+* the current one is processed and memory stays bounded by the chunk size. A file whose size is not
+* a whole number of points is treated as a read error, the fit fails instead of dropping the rest.
+*
+* The initial estimate comes from one pass of sufficient statistics (an algebraic least squares
+* fit), since the point triplet initializer cannot run on the whole file. Refinement runs
+* Hypersphere_Fitter on a point source that streams the file, so every sweep of the engine is a
+* pass: one for the Newton step along the direction, and one for the radius, cost and gradient at
+* the new center.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#pragma once
+#ifndef STREAMING_FITTER
+#define STREAMING_FITTER
+
+class Streamed_Points;
+
+struct Streaming_Stats {
+	unsigned int passes;
+	unsigned long long points;
+	unsigned long long bytes_read;
+	double io_seconds; // Time spent reading, overlapped with compute by the prefetch
+	double compute_seconds;
+	double stall_seconds; // Time compute waited for a chunk that was not read yet
+	double wall_seconds;
+};
+
+class Streaming_Fitter
+{
+private:
+	std::string path;
+	size_t chunk_points;
+	double step_tolerance;
+	double radius_estimate;
+	Circle_Center circle_center_est;
+	double cost;
+	Streaming_Stats stats;
+
+	bool stream_pass(const std::function<void(const cv::Point*, size_t)>&);
+	bool initial_estimate();
+	friend class Streamed_Points;
+public:
+
+	Streaming_Fitter(const std::string&, size_t chunk_points = 1 << 20, double step_tolerance = 1.0e-6);
+	bool compute_best_fit_circle();
+	double get_radius();
+	Circle_Center get_center_coordinate();
+	double get_cost();
+	Streaming_Stats get_stats();
+};
+#endif
@@ -0,0 +1,119 @@
+/*
+* @file Weighted_Refinement.h
+* @brief Weighted point source of Hypersphere_Fitter, for fitters that refine a circle with a weight
+* per point (Robust_Fitter's M-estimator weights, Bootstrap_Fitter's resampled multiplicities). The
+* refinement is the POLAK and RIBI`ERE method of Hypersphere_Fitter with the radius taken as the
+* weighted mean distance and the cost as the weighted sum of squared residuals.
+*
+* Every step of the refinement needs two sweeps: one for the Newton step along the direction, and
+* one for the radius, cost and gradient at the new center.
+*
+*/
+
+#include "Best_Fitting_Circle.h"
+#include "Hypersphere_Fitter.h"
+#include "Parallel_Blocks.h"
+#include <array>
+#include <vector>
+
+#pragma once
+#ifndef WEIGHTED_REFINEMENT
+#define WEIGHTED_REFINEMENT
+
+/*
+* Point source reading the caller's coordinate and weight arrays in place. A point with a zero
+* weight adds nothing to the sums, and a sweep is split over the worker threads with parallel_blocks
+*/
+class Weighted_Point_View
+{
+private:
+	const double* xs;
+	const double* ys;
+	const double* weights;
+	size_t count;
+	unsigned int thread_count;
+public:
+
+	/**
+	* Constructor to refer to the caller's arrays, which must outlive the fitter
+	*
+	* @param xs x coordinates of the points
+	* @param ys y coordinates of the points
+	* @param weights Weight of every point, nullptr weighs every point 1
+	* @param count Number of points
+	* @param thread_count Number of threads a sweep is split over
+	*/
+	Weighted_Point_View(const double* xs, const double* ys, const double* weights, size_t count, unsigned int thread_count = 1) {
+		this->xs = xs;
+		this->ys = ys;
+		this->weights = weights;
+		this->count = count;
+		this->thread_count = (thread_count > 0) ? thread_count : 1;
+	}
+	size_t size() const {
+		return count;
+	}
+	void get_point(size_t i, double* p) const {
+		p[0] = xs[i];
+		p[1] = ys[i];
+	}
+	template <int S, typename Body>
+	bool sweep(double(&totals)[S], Body body) const {
+		auto sweep_block = [&](size_t begin, size_t end, double(&sums)[S]) {
+			sweep_in_lanes(end - begin, sums, [&](size_t k, double* accumulator) {
+				size_t i = begin + k;
+				double p[2] = { xs[i], ys[i] };
+				body(p, (weights != nullptr) ? weights[i] : 1.0, accumulator);
+			});
+		};
+		if (thread_count == 1)
+		{
+			sweep_block(0, count, totals);
+			return true;
+		}
+		std::vector<std::array<double, S>> partial(thread_count);
+		unsigned int blocks = parallel_blocks(count, thread_count, [&](size_t begin, size_t end, unsigned int block) {
+			double sums[S] = {};
+			sweep_block(begin, end, sums);
+			for (int s = 0; s < S; ++s) {
+				partial[block][s] = sums[s];
+			}
+		});
+		for (unsigned int b = 0; b < blocks; ++b) {
+			for (int s = 0; s < S; ++s) {
+				totals[s] += partial[b][s];
+			}
+		}
+		return true;
+	}
+};
+
+/**
+* Refines a circle on weighted points for at most max_steps line search steps
+*
+* @param points Weighted points
+* @param center Starting center, replaced by the refined center
+* @param radius Radius at the starting center if known, replaced by the refined radius
+* @param cost Replaced by the cost of the refined circle
+* @param max_steps Maximum number of steps
+* @param step_tolerance Stop once a step would move the center less than this
+* @param sweep_count Incremented by the number of sweeps over the points, if not nullptr
+* @return true if the refinement converged within max_steps
+*/
+inline bool refine_weighted(const Weighted_Point_View& points, Circle_Center& center, double& radius, double& cost, int max_steps,
+	double step_tolerance = 0.0, int* sweep_count = nullptr) {
+	Hypersphere_Fitter<2, Weighted_Point_View> engine(points);
+	Fit_Budget budget;
+	budget.max_iterations = max_steps;
+	engine.set_budget(budget);
+	engine.set_step_tolerance(step_tolerance);
+	bool convergence = engine.refine_best_fit_sphere({ center.x, center.y }, radius);
+	center.x = engine.get_center()[0];
+	center.y = engine.get_center()[1];
+	radius = engine.get_radius();
+	cost = engine.get_cost();
+	if (sweep_count != nullptr)
+		*sweep_count += engine.get_sweep_count();
+	return convergence;
+}
+#endif
@@ -6,25 +6,22 @@
 * Contact: praneetheddu@gatech.edu
 */
 
+#include <opencv2/opencv.hpp>
 #include <iostream>
 #include <vector>
 #include <stdlib.h>
 #include "Best_Fitting_Circle.h"
-#include "Grid_Points.h"
+#include "Grid_Model.h"
+#include "Mouse_State.h"
+#include "Fit_Cache.h"
+#include "Extremal_Circle_Fitter.h"
 
 
 // Instantiate global variables
-Grid_Points grid_points[20][20]; //2D array of Grid point class
-const unsigned int grid_spacing = 40; //Grid Spacing
+Grid_Model grid(40, 20); //20 x 20 grid of points with 40 pixel spacing
+Mouse_State mouse_state; //Left button state machine
 
-// Parameters to check for mouse activity
-bool left_button_clicked = false;
-bool left_button_released = true;
-bool clicked_flag = true;
-bool released_flag = true;
-bool draw_circ = false;
-
-std::vector<cv::Point> selected_points; //Vector for point selection
+Fit_Cache fit_cache(256); //Results of previously generated point selections
 cv::Mat background_with_grid; // Original grid image with no plots
 
 bool circle_generated = false; //Check to see if a circle aldready exists
@@ -37,22 +34,16 @@ cv::Point reset_bottom_right = cv::Point(670, 845);
 
 
 /**
- * Overlays grid points on white background
+ * Overlays grid points and buttons on white background
  *
  *
  * @param background image of white background
- * @param grid_spacing space between the grid points
  */
-void overlay_grid_points(cv::Mat& background, unsigned int grid_spacing) {
+void overlay_grid_points(cv::Mat& background) {
 	std::cout << "Creating Grid ...\n";
 
 	// Layout the points on the white background
-	for (unsigned int i = 1; i < 21; ++i) {
-		for (unsigned int j = 1; j < 21; ++j) {
-			grid_points[i - 1][j - 1].set_params(cv::Point(grid_spacing * i, grid_spacing * j), false);
-			cv::rectangle(background, grid_points[i - 1][j - 1].point, grid_points[i - 1][j - 1].grid_offset, grid_points[i - 1][j - 1].color, -1, 8, 0);
-		}
-	}
+	grid.draw(background);
 
 	//Add a button for Generate
 	cv::rectangle(background, generate_button_top_left, generate_button_bottom_right, cv::Scalar(199, 207, 196), -1, 8, 0);
@@ -115,7 +106,7 @@ bool click_contains_reset(int x, int y) {
 void reset_grid(cv::Mat& populated_image) {
 	background_with_grid.copyTo(populated_image); // Reset to original grid
 	circle_generated = false;
-	selected_points.clear(); //clear the selected points
+	grid.clear_selection(); // Deselect the grid points so that the next click selects them again
 }
 
 /**
@@ -134,32 +125,49 @@ void mouse_activity(int event, int x, int y, int flags, void* background) {
 	cv::Mat& img = *((cv::Mat*)(background)); // 1st cast it back, then deref
 	bool is_circle_computable; //Check to see if circle is computable
 
+	// Translate the OpenCV mouse event for the state machine
+	Mouse_Event mouse_event = (event == cv::EVENT_LBUTTONDOWN) ? mouse_button_down : ((event == cv::EVENT_LBUTTONUP) ? mouse_button_up : mouse_moved);
+	Mouse_Transition transition = mouse_state.update(mouse_event);
+	const std::vector<cv::Point>& selected_points = grid.get_selected_points();
+
 	if (event == cv::EVENT_LBUTTONDOWN)
 	{
-		// Recognize user's mouse click and set appropriate flags
-		left_button_clicked = true;
-		left_button_released = false;
-
 		if (click_contains_generate_box(x, y)) //Check to see if the generate button is clicked
 		{
 			if (selected_points.size() >= 3 && !circle_generated) // User has to select atlease 3 points
 			{
 
-				// Create an instance of Best Fitting Circle class
-				Best_Fitting_Circle* best_fit_circle = new Best_Fitting_Circle(selected_points);
-				is_circle_computable = best_fit_circle->compute_best_fit_circle(); //Check to see if the circle can be computed
+				// Reuse the result if the same points were generated before
+				Fit_Result fit_result;
+				if (!fit_cache.lookup(grid.get_selection_hash(), fit_result))
+				{
+					// Create an instance of Best Fitting Circle class
+					Best_Fitting_Circle best_fit_circle(selected_points);
+					fit_result.is_computable = best_fit_circle.compute_best_fit_circle(); //Check to see if the circle can be computed
+					fit_result.radius = best_fit_circle.get_radius();
+					fit_result.center = best_fit_circle.get_center_coordinate();
+					fit_cache.insert(grid.get_selection_hash(), fit_result);
+				}
+				is_circle_computable = fit_result.is_computable;
 
 				if (is_circle_computable)
 				{
 					// if the circle is computable, get radius and center coordinates
-					double radius = best_fit_circle->get_radius();
-					Circle_Center circle_center = best_fit_circle->get_center_coordinate();
+					double radius = fit_result.radius;
+					Circle_Center circle_center = fit_result.center;
 
 					// Check to see if the circle's center can fit in grid. Also accounts for invalid circle coordinates
 					if (circle_center.x < 850 && circle_center.y < 850)
 					{
 						// Draw the best fit circle
 						cv::circle(img, cv::Point(circle_center.x, circle_center.y), radius, cv::Scalar(255, 0, 0), 2, 8, 0);
+
+						// Draw the maximum inscribed and minimum enclosing circles in red, the inner and outer envelopes of the points
+						for (Fit_Mode mode : { maximum_inscribed_fit, minimum_enclosing_fit }) {
+							Fit_Result envelope = fit_circle(selected_points, mode);
+							if (envelope.is_computable)
+								cv::circle(img, cv::Point(envelope.center.x, envelope.center.y), envelope.radius, cv::Scalar(0, 0, 255), 2, 8, 0);
+						}
 						circle_generated = true;
 						imshow("Digitizing Circles", img);
 					}
@@ -187,55 +195,15 @@ void mouse_activity(int event, int x, int y, int flags, void* background) {
 			std::cout << "Grid Reset\n" << std::endl;;
 		}
 	}
-	if (event == cv::EVENT_LBUTTONUP)
-	{
-		//Recognize user's mouse release and set appropriate flags
-		left_button_released = true;
-		left_button_clicked = false;
-	}
-
-	if (left_button_clicked && clicked_flag)
+	if (transition == button_released)
 	{
-		clicked_flag = false;
-		released_flag = true;
-	}
-
-
-	if (left_button_released && released_flag)
-	{
-		draw_circ = true;
-		released_flag = false;
-		clicked_flag = true;
-
-	}
-
-	if (draw_circ && left_button_released)
-	{
-		draw_circ = false;
-		if (x % grid_spacing < 5 && y % grid_spacing < 5) // Check to see if region of grid point overlaps mouse click coordinates
+		int i, j;
+		if (grid.find_grid_point(x, y, i, j)) // Check to see if region of grid point overlaps mouse click coordinates
 		{
-			//Calculate index of overlapped grid coordinates
-			int indx_x = (x - (x % grid_spacing)) / 40;
-			int indx_y = (y - (y % grid_spacing)) / 40;
-
-			grid_points[indx_x - 1][indx_y - 1].toggle(); //Toggle the grid point 
+			grid.toggle(i, j); //Toggle the grid point and update the selected points and their hash
 
-			if (grid_points[indx_x - 1][indx_y - 1].get_is_selected()) // Check if the grid point is marked for selection
-			{
-				selected_points.push_back(grid_points[indx_x - 1][indx_y - 1].point);
-			}
-			else //if not selected, remove the grid point from the selected points list
-			{
-				//Remove the element from the selected points array if the point is not present
-				for (auto point : selected_points) {
-					if (point.x == grid_points[indx_x - 1][indx_y - 1].point.x && point.y == grid_points[indx_x - 1][indx_y - 1].point.y)
-					{
-						selected_points.erase(std::remove(selected_points.begin(), selected_points.end(), point), selected_points.end());
-					}
-				}
-			}
 			// Color the selected grid point based on the toggle value
-			cv::rectangle(img, grid_points[indx_x - 1][indx_y - 1].point, grid_points[indx_x - 1][indx_y - 1].grid_offset, grid_points[indx_x - 1][indx_y - 1].color, -1, 8, 0);
+			grid.draw_point(img, i, j);
 			imshow("Digitizing Circles", img); //Display the image
 		}
 	}
@@ -252,7 +220,7 @@ int main() {
 		return -1; // Unsucessful image loading
 	}
 	//Overlay the image with grid points
-	overlay_grid_points(white_background, grid_spacing);
+	overlay_grid_points(white_background);
 
 	// Create a copy of the image with grid to use when circles need to be cleared
 	white_background.copyTo(background_with_grid);
@@ -0,0 +1,91 @@
+/*
+* @file Bounded_Queue.h
+* @brief Blocking queue of fixed capacity used to hand frames from one pipeline stage to the next.
+* A full queue blocks the producer so that a slow stage applies back pressure instead of letting
+* frames pile up in memory. The queue also records its depth for the pipeline metrics.
+*
+*/
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#pragma once
+#ifndef BOUNDED_QUEUE
+#define BOUNDED_QUEUE
+
+template <typename T>
+class Bounded_Queue
+{
+private:
+	size_t capacity;
+	std::deque<T> items;
+	bool closed = false;
+	std::mutex queue_mutex;
+	std::condition_variable not_empty;
+	std::condition_variable not_full;
+
+	// Depth metrics sampled on every push
+	size_t max_depth = 0;
+	unsigned long long depth_sum = 0;
+	unsigned long long push_count = 0;
+public:
+
+	Bounded_Queue(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+	/**
+	* Adds an item, waiting while the queue is full
+	*
+	* @param item Item to add
+	*/
+	void push(T item) {
+		std::unique_lock<std::mutex> lock(queue_mutex);
+		not_full.wait(lock, [this] { return items.size() < capacity; });
+		items.push_back(std::move(item));
+		max_depth = std::max(max_depth, items.size());
+		depth_sum += items.size();
+		++push_count;
+		not_empty.notify_one();
+	}
+
+	/**
+	* Removes the oldest item, waiting while the queue is empty
+	*
+	* @param item Removed item
+	* @return false once the queue is closed and drained
+	*/
+	bool pop(T& item) {
+		std::unique_lock<std::mutex> lock(queue_mutex);
+		not_empty.wait(lock, [this] { return !items.empty() || closed; });
+		if (items.empty())
+			return false;
+		item = std::move(items.front());
+		items.pop_front();
+		not_full.notify_one();
+		return true;
+	}
+
+	/**
+	* Marks the end of the stream. Consumers drain the remaining items and then stop
+	*/
+	void close() {
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		closed = true;
+		not_empty.notify_all();
+	}
+
+	size_t get_capacity() {
+		return capacity;
+	}
+
+	size_t get_max_depth() {
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		return max_depth;
+	}
+
+	double get_mean_depth() {
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		return push_count > 0 ? (double)depth_sum / push_count : 0.0;
+	}
+};
+#endif
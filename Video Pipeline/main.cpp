@@ -0,0 +1,276 @@
+/*
+* @file main.cpp
+* @brief Fits best fit circles to the contours found in every frame of a video file or image sequence.
+*
+* The work is split into pipeline stages that run on their own threads and hand frames to each
+* other through bounded queues:
+*   1. read       decode the next frame
+*   2. edges      convert to gray scale and extract edge points with Canny
+*   3. contours   group the edge points into contours and sample the points to fit
+*   4. fit        fit a circle to every contour with Batch_Fitter, in parallel across contours
+*   5. annotate   draw the fitted circles and write the output frame
+* Frames stay in order because every stage is a single consumer of its input queue. At the end the
+* throughput of every stage and the depth of every queue is printed.
+*
+* Usage: Video_Pipeline <input video | "frames/img_*.png"> [output video | ""] [queue_capacity] [fit_threads]
+*
+*/
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include "Bounded_Queue.h"
+#include "../Toggle Points Method/Batch_Fitter.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct Frame {
+	unsigned long long index;
+	cv::Mat image;
+	cv::Mat edges;
+	std::vector<std::vector<cv::Point>> contours; // Sampled points of every contour to fit
+	std::vector<Fit_Result> circles;
+};
+
+struct Stage_Metrics {
+	std::string name;
+	unsigned long long frames = 0;
+	double busy_seconds = 0.0;
+};
+
+// Contour selection parameters
+const size_t min_contour_points = 30; // Shorter contours are treated as noise
+const size_t max_fit_points = 24; // Points sampled from each contour for the fit
+
+/**
+* Measures the time spent on the work of a stage, not counting the time blocked on its queues
+*/
+class Stage_Timer
+{
+private:
+	Stage_Metrics& metrics;
+	Clock::time_point start;
+	bool counted = true;
+public:
+	Stage_Timer(Stage_Metrics& metrics) : metrics(metrics), start(Clock::now()) {}
+	~Stage_Timer() {
+		metrics.busy_seconds += std::chrono::duration<double>(Clock::now() - start).count();
+		if (counted)
+			++metrics.frames;
+	}
+	void no_frame() { counted = false; } // The timed work did not produce a frame
+};
+
+/**
+* Reads frames from a video file, or from the files matching a glob pattern, into the first queue
+*
+* @param input Video path or image glob pattern
+* @param output Queue of decoded frames
+* @param metrics Metrics of the read stage
+*/
+void read_stage(std::string input, Bounded_Queue<Frame>* output, Stage_Metrics* metrics) {
+	unsigned long long index = 0;
+	if (input.find('*') != std::string::npos)
+	{
+		std::vector<std::string> files;
+		cv::glob(input, files, false);
+		for (auto& file : files) {
+			Frame frame;
+			{
+				Stage_Timer timer(*metrics);
+				frame.index = index++;
+				frame.image = cv::imread(file);
+				if (frame.image.empty())
+					timer.no_frame();
+			}
+			if (!frame.image.empty())
+				output->push(std::move(frame));
+		}
+	}
+	else
+	{
+		cv::VideoCapture capture(input);
+		if (!capture.isOpened())
+			std::cout << "Could not open " << input << std::endl;
+		while (capture.isOpened()) {
+			Frame frame;
+			{
+				Stage_Timer timer(*metrics);
+				frame.index = index++;
+				if (!capture.read(frame.image))
+				{
+					timer.no_frame();
+					break;
+				}
+			}
+			output->push(std::move(frame));
+		}
+	}
+	output->close();
+}
+
+/**
+* Extracts the edge points of every frame
+*
+* @param input Queue of decoded frames
+* @param output Queue of frames with their edge image
+* @param metrics Metrics of the edge stage
+*/
+void edge_stage(Bounded_Queue<Frame>* input, Bounded_Queue<Frame>* output, Stage_Metrics* metrics) {
+	Frame frame;
+	while (input->pop(frame)) {
+		{
+			Stage_Timer timer(*metrics);
+			cv::Mat gray;
+			cv::cvtColor(frame.image, gray, cv::COLOR_BGR2GRAY);
+			cv::Canny(gray, frame.edges, 50, 150);
+		}
+		output->push(std::move(frame));
+	}
+	output->close();
+}
+
+/**
+* Groups edge points into contours and samples evenly spaced points along every long contour.
+* The triplet initializer of Best_Fitting_Circle grows with the cube of the point count, so
+* only max_fit_points points of each contour are fitted
+*
+* @param input Queue of frames with their edge image
+* @param output Queue of frames with the points to fit
+* @param metrics Metrics of the contour stage
+*/
+void contour_stage(Bounded_Queue<Frame>* input, Bounded_Queue<Frame>* output, Stage_Metrics* metrics) {
+	Frame frame;
+	while (input->pop(frame)) {
+		{
+			Stage_Timer timer(*metrics);
+			std::vector<std::vector<cv::Point>> contours;
+			cv::findContours(frame.edges, contours, cv::RETR_LIST, cv::CHAIN_APPROX_NONE);
+			frame.contours.clear();
+			for (auto& contour : contours) {
+				if (contour.size() < min_contour_points)
+					continue;
+				std::vector<cv::Point> sampled;
+				size_t count = std::min(max_fit_points, contour.size());
+				for (size_t i = 0; i < count; ++i) {
+					sampled.push_back(contour[i * contour.size() / count]);
+				}
+				frame.contours.push_back(std::move(sampled));
+			}
+		}
+		output->push(std::move(frame));
+	}
+	output->close();
+}
+
+/**
+* Fits a circle to every contour of the frame, spreading the contours over the fit threads
+*
+* @param input Queue of frames with the points to fit
+* @param output Queue of frames with their fitted circles
+* @param fit_threads Number of threads used to fit the contours of one frame
+* @param metrics Metrics of the fit stage
+*/
+void fit_stage(Bounded_Queue<Frame>* input, Bounded_Queue<Frame>* output, unsigned int fit_threads, Stage_Metrics* metrics) {
+	Batch_Fitter batch_fitter(fit_threads);
+	Frame frame;
+	while (input->pop(frame)) {
+		{
+			Stage_Timer timer(*metrics);
+			frame.circles = batch_fitter.fit(frame.contours);
+		}
+		output->push(std::move(frame));
+	}
+	output->close();
+}
+
+/**
+* Draws the fitted circles on the frame and writes it to the output video
+*
+* @param input Queue of frames with their fitted circles
+* @param output_path Output video path, empty to skip writing
+* @param fps Frame rate of the output video
+* @param metrics Metrics of the annotate stage
+*/
+void annotate_stage(Bounded_Queue<Frame>* input, std::string output_path, double fps, Stage_Metrics* metrics) {
+	cv::VideoWriter writer;
+	Frame frame;
+	while (input->pop(frame)) {
+		Stage_Timer timer(*metrics);
+		int size_limit = std::max(frame.image.cols, frame.image.rows);
+		for (auto& circle : frame.circles) {
+			// Skip circles that could not be fitted or are far bigger than the frame
+			if (!circle.is_computable || circle.radius <= 0 || circle.radius > size_limit)
+				continue;
+			cv::circle(frame.image, cv::Point(circle.center.x, circle.center.y), circle.radius, cv::Scalar(0, 0, 255), 2, 8, 0);
+		}
+		if (output_path.empty())
+			continue;
+		if (!writer.isOpened())
+			writer = cv::VideoWriter(output_path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, frame.image.size());
+		writer.write(frame.image);
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2)
+	{
+		std::cout << "Usage: Video_Pipeline <input video | \"image/glob/*.png\"> [output video | \"\"] [queue_capacity] [fit_threads]" << std::endl;
+		return -1;
+	}
+	std::string input_path = argv[1];
+	std::string output_path = (argc > 2) ? argv[2] : "";
+	size_t queue_capacity = (argc > 3) ? std::atoi(argv[3]) : 4;
+	unsigned int fit_threads = (argc > 4) ? std::atoi(argv[4]) : 0;
+
+	double fps = 30.0;
+	if (input_path.find('*') == std::string::npos)
+	{
+		cv::VideoCapture probe(input_path);
+		if (probe.isOpened() && probe.get(cv::CAP_PROP_FPS) > 0)
+			fps = probe.get(cv::CAP_PROP_FPS);
+	}
+
+	Bounded_Queue<Frame> decoded(queue_capacity), edged(queue_capacity), grouped(queue_capacity), fitted(queue_capacity);
+	std::vector<Stage_Metrics> metrics(5);
+	metrics[0].name = "read";
+	metrics[1].name = "edges";
+	metrics[2].name = "contours";
+	metrics[3].name = "fit";
+	metrics[4].name = "annotate";
+
+	Clock::time_point start = Clock::now();
+	std::vector<std::thread> stages;
+	stages.emplace_back(read_stage, input_path, &decoded, &metrics[0]);
+	stages.emplace_back(edge_stage, &decoded, &edged, &metrics[1]);
+	stages.emplace_back(contour_stage, &edged, &grouped, &metrics[2]);
+	stages.emplace_back(fit_stage, &grouped, &fitted, fit_threads, &metrics[3]);
+	stages.emplace_back(annotate_stage, &fitted, output_path, fps, &metrics[4]);
+	for (auto& stage : stages) {
+		stage.join();
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	// Print the throughput of every stage and the depth of the queue feeding it
+	Bounded_Queue<Frame>* input_queues[5] = { nullptr, &decoded, &edged, &grouped, &fitted };
+	unsigned long long frames = metrics[4].frames;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << frames << " frames in " << seconds << " s (" << frames / seconds << " fps)" << std::endl;
+	std::cout << std::setw(10) << "stage" << std::setw(12) << "busy fps" << std::setw(12) << "busy %"
+		<< std::setw(14) << "mean queue" << std::setw(12) << "max queue" << std::endl;
+	for (size_t i = 0; i < metrics.size(); ++i) {
+		std::cout << std::setw(10) << metrics[i].name
+			<< std::setw(12) << (metrics[i].busy_seconds > 0 ? metrics[i].frames / metrics[i].busy_seconds : 0.0)
+			<< std::setw(12) << 100.0 * metrics[i].busy_seconds / seconds;
+		if (input_queues[i] != nullptr)
+			std::cout << std::setw(14) << input_queues[i]->get_mean_depth() << std::setw(8) << input_queues[i]->get_max_depth()
+				<< "/" << input_queues[i]->get_capacity();
+		std::cout << std::endl;
+	}
+	return 0;
+}